@@ -27,55 +27,172 @@ SOFTWARE.
 
 #include "dom.hpp"
 
+#include <algorithm>
+#include <new>
+
+#include <fsif/native_file.hpp>
+#include <utki/config.hpp>
+#include <utki/util.hpp>
+
+#if CFG_OS == CFG_OS_LINUX || CFG_OS == CFG_OS_MACOSX || CFG_OS == CFG_OS_UNIX
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#	define SVGDOM_HAVE_MMAP
+#endif
+
 #include "config.hpp"
 #include "parser.hxx"
+#include "thread_pool.hxx"
 
 using namespace svgdom;
 
-std::unique_ptr<svg_element> svgdom::load(const fsif::file& f)
+#ifdef SVGDOM_HAVE_MMAP
+namespace {
+/**
+ * @brief Read-only memory mapping of a whole file.
+ */
+class mapped_file
 {
-	svgdom::parser parser;
+	void* data = MAP_FAILED;
+	size_t size = 0;
 
+public:
+	mapped_file(const std::string& path)
 	{
-		fsif::file::guard file_guard(f);
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return;
+		}
 
-		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-		std::array<uint8_t, size_t(utki::kilobyte) * 4> buf;
+		utki::scope_exit fd_scope_exit([fd]() {
+			close(fd);
+		});
 
-		while (true) {
-			auto res = f.read(utki::make_span(buf));
-			ASSERT(res <= buf.size())
-			if (res == 0) {
-				break;
-			}
-			parser.feed(utki::make_span(buf.data(), res));
+		struct stat st {};
+		if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+			return;
 		}
-		parser.end();
+
+		this->size = size_t(st.st_size);
+
+		this->data = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (this->data == MAP_FAILED) {
+			return;
+		}
+
+		// the file is parsed from start to end
+		madvise(this->data, this->size, MADV_SEQUENTIAL);
 	}
 
-	return parser.get_dom();
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	mapped_file(mapped_file&&) = delete;
+	mapped_file& operator=(mapped_file&&) = delete;
+
+	~mapped_file()
+	{
+		if (this->is_mapped()) {
+			munmap(this->data, this->size);
+		}
+	}
+
+	bool is_mapped() const noexcept
+	{
+		return this->data != MAP_FAILED;
+	}
+
+	utki::span<const char> get() const noexcept
+	{
+		ASSERT(this->is_mapped())
+		return utki::make_span(static_cast<const char*>(this->data), this->size);
+	}
+};
+} // namespace
+#endif
+
+namespace {
+void parse(svgdom::parser& parser, utki::span<const char> buf)
+{
+	parser.feed(buf);
+	parser.end();
 }
+} // namespace
 
-std::unique_ptr<svg_element> svgdom::load(std::istream& s)
+namespace {
+void parse(svgdom::parser& parser, const fsif::file& f)
 {
-	svgdom::parser parser;
+#ifdef SVGDOM_HAVE_MMAP
+	// native files are mapped to memory and parsed in one go
+	if (dynamic_cast<const fsif::native_file*>(&f)) {
+		mapped_file mf(std::string(f.path()));
+		if (mf.is_mapped()) {
+			parse(parser, mf.get());
+			return;
+		}
+		// fall back to reading the file by chunks
+	}
+#endif
 
-	static const size_t chunk_size = 0x1000; // 4kb
+	fsif::file::guard file_guard(f);
 
-	while (!s.eof()) {
-		std::vector<char> buf;
-		buf.reserve(chunk_size);
-		for (size_t i = 0; i != chunk_size; ++i) {
-			auto c = char(s.get());
-			if (s.eof()) {
-				break;
-			}
-			buf.push_back(c);
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+	std::array<uint8_t, size_t(utki::kilobyte) * 4> buf;
+
+	while (true) {
+		auto res = f.read(utki::make_span(buf));
+		ASSERT(res <= buf.size())
+		if (res == 0) {
+			break;
+		}
+		parser.feed(utki::make_span(buf.data(), res));
+	}
+	parser.end();
+}
+} // namespace
+
+namespace {
+void parse(svgdom::parser& parser, std::istream& s, size_t size_hint)
+{
+	constexpr size_t default_chunk_size = size_t(utki::kilobyte) * 64;
+	constexpr size_t max_chunk_size = size_t(utki::megabyte) * 16;
+
+	// In case the size is hinted, try to read the whole stream at once.
+	// One extra byte is needed to detect the end of stream without one more read.
+	// The hint is not trusted beyond the maximum chunk size, bigger streams are read by maximum size chunks.
+	std::vector<char> buf(size_hint == 0 ? default_chunk_size : std::min(size_hint, max_chunk_size - 1) + 1);
+
+	while (s) {
+		s.read(buf.data(), std::streamsize(buf.size()));
+		auto num_read = s.gcount();
+		if (num_read <= 0) {
+			break;
 		}
-		parser.feed(utki::make_span(buf));
+		parser.feed(utki::make_span(buf.data(), size_t(num_read)));
 	}
 	parser.end();
+}
+} // namespace
+
+std::unique_ptr<svg_element> svgdom::load(const fsif::file& f)
+{
+	svgdom::parser parser;
+	parse(parser, f);
+	return parser.get_dom();
+}
 
+std::unique_ptr<svg_element> svgdom::load(std::istream& s)
+{
+	return load(s, 0);
+}
+
+std::unique_ptr<svg_element> svgdom::load(std::istream& s, size_t size_hint)
+{
+	svgdom::parser parser;
+	parse(parser, s, size_hint);
 	return parser.get_dom();
 }
 
@@ -92,9 +209,323 @@ std::unique_ptr<svg_element> svgdom::load(utki::span<const uint8_t> buf)
 std::unique_ptr<svg_element> svgdom::load(utki::span<const char> buf)
 {
 	svgdom::parser parser;
+	parse(parser, buf);
+	return parser.get_dom();
+}
 
-	parser.feed(buf);
-	parser.end();
+std::unique_ptr<svg_element> svgdom::load(const fsif::file& f, const load_options& options)
+{
+	svgdom::parser parser;
+	parser.set_options(options);
+	parse(parser, f);
+	return parser.get_dom();
+}
+
+std::unique_ptr<svg_element> svgdom::load(std::string_view s, const load_options& options)
+{
+	return load(utki::make_span(s), options);
+}
 
+std::unique_ptr<svg_element> svgdom::load(utki::span<const char> buf, const load_options& options)
+{
+	svgdom::parser parser;
+	parser.set_options(options);
+	parse(parser, buf);
 	return parser.get_dom();
 }
+
+load_result svgdom::try_load(std::string_view s)
+{
+	return try_load(utki::make_span(s));
+}
+
+load_result svgdom::try_load(utki::span<const uint8_t> buf)
+{
+	return try_load(to_char(buf));
+}
+
+namespace {
+// Returns offset of the byte at which the parser detects the error in the buffer,
+// or size of the buffer in case the error is detected at the end of the input.
+// The buffer is fed to the parser byte by byte, which is slow, so it is only done
+// when it is already known that the buffer has an error.
+size_t find_error_offset(svgdom::parser& parser, utki::span<const char> buf)
+{
+	parser.reset();
+
+	size_t offset = 0;
+
+	// mikroxml reports malformed XML only by throwing
+	try {
+		for (; offset != buf.size(); ++offset) {
+			parser.feed(buf.subspan(offset, 1));
+			if (parser.has_error()) {
+				return offset;
+			}
+		}
+		parser.end();
+	} catch (std::bad_alloc&) {
+		throw;
+	} catch (std::exception&) {
+		return offset;
+	}
+
+	return offset;
+}
+
+load_result try_parse(svgdom::parser& parser, utki::span<const char> buf, bool locate_errors)
+{
+	load_result ret;
+
+	// mikroxml reports malformed XML only by throwing, so it is the only exception caught here
+	try {
+		parser.feed(buf);
+		parser.end();
+
+		if (auto error = parser.get_error(); !error.empty()) {
+			ret.error = error;
+		}
+	} catch (std::bad_alloc&) {
+		throw;
+	} catch (std::exception& e) {
+		ret.error = e.what();
+	}
+
+	ret.stats = parser.get_stats();
+
+	if (ret.error.empty()) {
+		ret.dom = parser.get_dom();
+		return ret;
+	}
+
+	if (!locate_errors) {
+		return ret;
+	}
+
+	// the error position is only needed in case of error, so it is found by parsing the buffer once again
+	auto offset = find_error_offset(parser, buf);
+
+	auto before_error = buf.subspan(0, offset);
+	auto line_start = std::find(before_error.rbegin(), before_error.rend(), '\n').base();
+
+	ret.line = size_t(std::count(before_error.begin(), before_error.end(), '\n')) + 1;
+	ret.column = size_t(before_error.end() - line_start) + 1;
+
+	return ret;
+}
+
+load_result try_parse(svgdom::parser& parser, const fsif::file& f, bool locate_errors)
+{
+#ifdef SVGDOM_HAVE_MMAP
+	// native files are mapped to memory, the error position is then found in the mapped memory as well
+	if (dynamic_cast<const fsif::native_file*>(&f)) {
+		mapped_file mf(std::string(f.path()));
+		if (mf.is_mapped()) {
+			return try_parse(parser, mf.get(), locate_errors);
+		}
+		// fall back to loading the file to memory
+	}
+#endif
+
+	std::vector<uint8_t> buf;
+	try {
+		buf = f.load();
+	} catch (std::bad_alloc&) {
+		throw;
+	} catch (std::exception& e) {
+		load_result ret;
+		ret.error = e.what();
+		return ret;
+	}
+	return try_parse(parser, to_char(utki::make_span(buf)), locate_errors);
+}
+} // namespace
+
+load_result svgdom::try_load(utki::span<const char> buf)
+{
+	svgdom::parser parser;
+	return try_parse(parser, buf, false);
+}
+
+load_result svgdom::try_load(std::string_view s, const load_options& options)
+{
+	return try_load(utki::make_span(s), options);
+}
+
+load_result svgdom::try_load(utki::span<const char> buf, const load_options& options)
+{
+	svgdom::parser parser;
+	parser.set_options(options);
+	return try_parse(parser, buf, options.locate_errors);
+}
+
+class svgdom::loader::impl
+{
+public:
+	// the parser keeps views of the allowed ids, so the options are stored along with it
+	const load_options options;
+	svgdom::parser parser;
+
+	explicit impl(const load_options& options) :
+		options(options)
+	{
+		this->parser.set_options(this->options);
+	}
+};
+
+svgdom::loader::loader(const load_options& options) :
+	pimpl(std::make_unique<impl>(options))
+{}
+
+svgdom::loader::loader(loader&&) noexcept = default;
+
+loader& svgdom::loader::operator=(loader&&) noexcept = default;
+
+svgdom::loader::~loader() = default;
+
+std::unique_ptr<svg_element> svgdom::loader::load(const fsif::file& f)
+{
+	auto& parser = this->pimpl->parser;
+	parser.reset();
+	parse(parser, f);
+	return parser.get_dom();
+}
+
+std::unique_ptr<svg_element> svgdom::loader::load(utki::span<const char> buf)
+{
+	auto& parser = this->pimpl->parser;
+	parser.reset();
+	parse(parser, buf);
+	return parser.get_dom();
+}
+
+std::unique_ptr<svg_element> svgdom::loader::load(std::string_view s)
+{
+	return this->load(utki::make_span(s));
+}
+
+std::unique_ptr<svg_element> svgdom::loader::load(utki::span<const uint8_t> buf)
+{
+	return this->load(to_char(buf));
+}
+
+load_result svgdom::loader::try_load(utki::span<const char> buf)
+{
+	auto& parser = this->pimpl->parser;
+	parser.reset();
+	return try_parse(parser, buf, this->pimpl->options.locate_errors);
+}
+
+load_result svgdom::loader::try_load(const fsif::file& f)
+{
+	auto& parser = this->pimpl->parser;
+	parser.reset();
+	return try_parse(parser, f, this->pimpl->options.locate_errors);
+}
+
+load_result svgdom::loader::try_load(std::string_view s)
+{
+	return this->try_load(utki::make_span(s));
+}
+
+load_result svgdom::loader::try_load(utki::span<const uint8_t> buf)
+{
+	return this->try_load(to_char(buf));
+}
+
+namespace {
+template <typename input_type>
+std::vector<load_result> load_concurrently(utki::span<const input_type> inputs, const load_options& options)
+{
+	auto& pool = thread_pool::get_shared();
+
+	size_t num_workers = options.num_threads == 0 ? pool.size() : std::min(size_t(options.num_threads), pool.size());
+
+	// the threads load different documents, so each document is loaded by a single thread
+	auto document_options = options;
+	document_options.num_threads = 1;
+
+	// the loader is reused by all the documents loaded by the same worker
+	std::vector<svgdom::loader> loaders;
+	loaders.reserve(num_workers);
+	for (size_t i = 0; i != num_workers; ++i) {
+		loaders.emplace_back(document_options);
+	}
+
+	std::vector<load_result> ret(inputs.size());
+
+	pool.run(
+		inputs.size(),
+		[&](size_t i, size_t worker) {
+			ret[i] = loaders[worker].try_load(inputs[i]);
+		},
+		num_workers
+	);
+
+	return ret;
+}
+
+load_options make_batch_options()
+{
+	load_options ret;
+	ret.num_threads = 0;
+	return ret;
+}
+} // namespace
+
+std::vector<load_result> svgdom::load_batch(utki::span<const utki::span<const char>> buffers)
+{
+	return load_batch(buffers, make_batch_options());
+}
+
+std::vector<load_result> svgdom::load_batch(
+	utki::span<const utki::span<const char>> buffers,
+	const load_options& options
+)
+{
+	return load_concurrently(buffers, options);
+}
+
+std::vector<load_result> svgdom::load_batch(utki::span<const std::reference_wrapper<const fsif::file>> files)
+{
+	return load_batch(files, make_batch_options());
+}
+
+std::vector<load_result> svgdom::load_batch(
+	utki::span<const std::reference_wrapper<const fsif::file>> files,
+	const load_options& options
+)
+{
+	return load_concurrently(files, options);
+}
+
+void svgdom::stream(const fsif::file& f, visitor& v)
+{
+	svgdom::parser parser(v);
+	parse(parser, f);
+	parser.throw_if_error();
+}
+
+void svgdom::stream(std::istream& s, visitor& v)
+{
+	svgdom::parser parser(v);
+	parse(parser, s, 0);
+	parser.throw_if_error();
+}
+
+void svgdom::stream(std::string_view s, visitor& v)
+{
+	stream(utki::make_span(s), v);
+}
+
+void svgdom::stream(utki::span<const uint8_t> buf, visitor& v)
+{
+	stream(to_char(buf), v);
+}
+
+void svgdom::stream(utki::span<const char> buf, visitor& v)
+{
+	svgdom::parser parser(v);
+	parse(parser, buf);
+	parser.throw_if_error();
+}
@@ -27,16 +27,23 @@ SOFTWARE.
 
 #pragma once
 
+#include <functional>
+#include <istream>
+
 #include <fsif/file.hpp>
 #include <utki/config.hpp>
 
 #include "elements/structurals.hpp"
 
+#include "load_options.hpp"
+
 namespace svgdom {
 
 /**
  * @brief Load SVG document.
  * Load SVG document from XML file.
+ * If the file is a fsif::native_file, then, where supported, the whole file is mapped to memory
+ * and parsed in one go. Otherwise, the file is read by chunks.
  * @param f - file interface to load SVG from.
  * @return unique pointer to the root of SVG document tree.
  */
@@ -50,6 +57,19 @@ std::unique_ptr<svg_element> load(const fsif::file& f);
  */
 std::unique_ptr<svg_element> load(std::istream& s);
 
+/**
+ * @brief Load SVG document.
+ * Load SVG document from XML stream.
+ * The stream is read by big chunks into a reused buffer. If the stream size is known in advance,
+ * e.g. from a container format header, then it can be passed as a hint, in which case the stream
+ * is read with a single read in the best case. The read buffer is limited to 16 megabytes
+ * regardless of the hint, so bigger streams are read by several reads.
+ * @param s - input stream to load SVG from.
+ * @param size_hint - expected number of bytes in the stream, 0 if unknown.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load(std::istream& s, size_t size_hint);
+
 /**
  * @brief Load SVG document.
  * Load SVG document from std::string.
@@ -72,4 +92,315 @@ std::unique_ptr<svg_element> load(utki::span<const char> buf);
  */
 std::unique_ptr<svg_element> load(utki::span<const uint8_t> buf);
 
+/**
+ * @brief Load SVG document selectively.
+ * Elements not selected by the load options are skipped together with their subtrees.
+ * Same as load(const fsif::file&) otherwise.
+ * @param f - file interface to load SVG from.
+ * @param options - selective loading options.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load(const fsif::file& f, const load_options& options);
+
+/**
+ * @brief Load SVG document selectively.
+ * Same as load(const fsif::file&, const load_options&).
+ * @param s - input string to load SVG from.
+ * @param options - selective loading options.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load(std::string_view s, const load_options& options);
+
+/**
+ * @brief Load SVG document selectively.
+ * Same as load(const fsif::file&, const load_options&).
+ * @param buf - input buffer to load SVG from.
+ * @param options - selective loading options.
+ * @return unique pointer to the root of SVG document tree.
+ */
+std::unique_ptr<svg_element> load(utki::span<const char> buf, const load_options& options);
+
+/**
+ * @brief Result of SVG document loading.
+ */
+struct load_result {
+	/**
+	 * @brief Loaded SVG document.
+	 * nullptr in case of error.
+	 */
+	std::unique_ptr<svg_element> dom;
+
+	/**
+	 * @brief Error description.
+	 * Empty in case the document was loaded successfully.
+	 */
+	std::string error;
+
+	/**
+	 * @brief Line number where the error was found.
+	 * Line numbers start from 1. 0 in case the document was loaded successfully
+	 * or the error position was not requested, see load_options::locate_errors.
+	 */
+	size_t line = 0;
+
+	/**
+	 * @brief Column number within the line where the error was found.
+	 * Column numbers are byte offsets within the line, starting from 1.
+	 * 0 in case the document was loaded successfully or the error position was not requested.
+	 */
+	size_t column = 0;
+
+	/**
+	 * @brief Numbers of bytes parsed and skipped.
+	 */
+	load_stats stats;
+
+	explicit operator bool() const noexcept
+	{
+		return this->dom != nullptr;
+	}
+};
+
+/**
+ * @brief Load SVG document without throwing on malformed input.
+ * Unlike load(), malformed SVG or XML content does not result in an exception being thrown,
+ * instead the error is reported via the returned value.
+ * The input is parsed only once, the error is reported without its position.
+ * Use try_load(utki::span<const char>, const load_options&) with load_options::locate_errors
+ * to get the error position.
+ * @param buf - input buffer to load SVG from.
+ * @return loaded document or error description.
+ */
+load_result try_load(utki::span<const char> buf);
+
+/**
+ * @brief Load SVG document without throwing on malformed input.
+ * Same as try_load(utki::span<const char>).
+ * @param s - input string to load SVG from.
+ * @return loaded document or error description.
+ */
+load_result try_load(std::string_view s);
+
+/**
+ * @brief Load SVG document without throwing on malformed input.
+ * Same as try_load(utki::span<const char>).
+ * @param buf - input buffer to load SVG from.
+ * @return loaded document or error description.
+ */
+load_result try_load(utki::span<const uint8_t> buf);
+
+/**
+ * @brief Load SVG document selectively without throwing on malformed input.
+ * Combines try_load(utki::span<const char>) and load(utki::span<const char>, const load_options&).
+ * @param buf - input buffer to load SVG from.
+ * @param options - selective loading options.
+ * @return loaded document or error description, and loading statistics.
+ */
+load_result try_load(utki::span<const char> buf, const load_options& options);
+
+/**
+ * @brief Load SVG document selectively without throwing on malformed input.
+ * Same as try_load(utki::span<const char>, const load_options&).
+ * @param s - input string to load SVG from.
+ * @param options - selective loading options.
+ * @return loaded document or error description, and loading statistics.
+ */
+load_result try_load(std::string_view s, const load_options& options);
+
+/**
+ * @brief Load several SVG documents concurrently.
+ * The documents are loaded on the thread pool shared by all loads of the process,
+ * using at most options.num_threads threads, 0 means number of hardware threads.
+ * Each thread reuses its parser state from one document to the next.
+ * Each document is loaded as by try_load(utki::span<const char>, const load_options&),
+ * so a malformed document does not prevent loading of the rest of the batch.
+ * Heavy attributes of a single document are never decoded in parallel within the batch,
+ * the threads are used to load different documents at the same time instead.
+ * @param buffers - input buffers to load SVG documents from.
+ * @param options - loading options applied to each document.
+ * @return loading results, one per input buffer, in the same order as the input buffers.
+ */
+std::vector<load_result> load_batch(
+	utki::span<const utki::span<const char>> buffers,
+	const load_options& options
+);
+
+/**
+ * @brief Load several SVG documents concurrently.
+ * Same as load_batch(utki::span<const utki::span<const char>>, const load_options&)
+ * with default options, except that all hardware threads are used.
+ * @param buffers - input buffers to load SVG documents from.
+ * @return loading results, one per input buffer, in the same order as the input buffers.
+ */
+std::vector<load_result> load_batch(utki::span<const utki::span<const char>> buffers);
+
+/**
+ * @brief Load several SVG documents concurrently.
+ * Same as load_batch(utki::span<const utki::span<const char>>, const load_options&),
+ * but reads the documents from files. The files are read on the loading threads,
+ * native files are mapped to memory instead of being read where possible.
+ * In case a file cannot be read, the error is reported in the corresponding load result.
+ * Since the files are read concurrently, the same file object must not appear in the batch more than once.
+ * @param files - file interfaces to load SVG documents from.
+ * @param options - loading options applied to each document.
+ * @return loading results, one per input file, in the same order as the input files.
+ */
+std::vector<load_result> load_batch(
+	utki::span<const std::reference_wrapper<const fsif::file>> files,
+	const load_options& options
+);
+
+/**
+ * @brief Load several SVG documents concurrently.
+ * Same as load_batch(utki::span<const std::reference_wrapper<const fsif::file>>, const load_options&)
+ * with default options, except that all hardware threads are used.
+ * @param files - file interfaces to load SVG documents from.
+ * @return loading results, one per input file, in the same order as the input files.
+ */
+std::vector<load_result> load_batch(utki::span<const std::reference_wrapper<const fsif::file>> files);
+
+/**
+ * @brief Reusable SVG document loader.
+ * Each of the load() functions creates a new parser and throws it away along with its internal buffers
+ * after the document is loaded. In contrast, the loader keeps its parser between the loads and only
+ * resets it before loading next document, while its internal buffers keep their capacity.
+ * This reduces the per-document overhead in case a lot of small documents are loaded, e.g. icons.
+ * The loader is not thread-safe, use one loader per thread.
+ */
+class loader
+{
+	class impl;
+	std::unique_ptr<impl> pimpl;
+
+public:
+	/**
+	 * @brief Create loader.
+	 * @param options - loading options applied to each document.
+	 */
+	explicit loader(const load_options& options = load_options());
+
+	loader(const loader&) = delete;
+	loader& operator=(const loader&) = delete;
+
+	loader(loader&&) noexcept;
+	loader& operator=(loader&&) noexcept;
+
+	~loader();
+
+	/**
+	 * @brief Load SVG document.
+	 * Same as svgdom::load(const fsif::file&, const load_options&).
+	 * @param f - file interface to load SVG from.
+	 * @return unique pointer to the root of SVG document tree.
+	 */
+	std::unique_ptr<svg_element> load(const fsif::file& f);
+
+	/**
+	 * @brief Load SVG document.
+	 * Same as svgdom::load(utki::span<const char>, const load_options&).
+	 * @param buf - input buffer to load SVG from.
+	 * @return unique pointer to the root of SVG document tree.
+	 */
+	std::unique_ptr<svg_element> load(utki::span<const char> buf);
+
+	/**
+	 * @brief Load SVG document.
+	 * Same as load(utki::span<const char>).
+	 * @param s - input string to load SVG from.
+	 * @return unique pointer to the root of SVG document tree.
+	 */
+	std::unique_ptr<svg_element> load(std::string_view s);
+
+	/**
+	 * @brief Load SVG document.
+	 * Same as load(utki::span<const char>).
+	 * @param buf - input buffer to load SVG from.
+	 * @return unique pointer to the root of SVG document tree.
+	 */
+	std::unique_ptr<svg_element> load(utki::span<const uint8_t> buf);
+
+	/**
+	 * @brief Load SVG document without throwing on malformed input.
+	 * Same as svgdom::try_load(utki::span<const char>, const load_options&).
+	 * @param buf - input buffer to load SVG from.
+	 * @return loaded document or error description, and loading statistics.
+	 */
+	load_result try_load(utki::span<const char> buf);
+
+	/**
+	 * @brief Load SVG document without throwing on malformed input.
+	 * Same as try_load(utki::span<const char>), but reads the document from file.
+	 * Native files are mapped to memory instead of being read where possible.
+	 * In case the file cannot be read, the error is reported in the returned value.
+	 * @param f - file interface to load SVG from.
+	 * @return loaded document or error description, and loading statistics.
+	 */
+	load_result try_load(const fsif::file& f);
+
+	/**
+	 * @brief Load SVG document without throwing on malformed input.
+	 * Same as try_load(utki::span<const char>).
+	 * @param s - input string to load SVG from.
+	 * @return loaded document or error description, and loading statistics.
+	 */
+	load_result try_load(std::string_view s);
+
+	/**
+	 * @brief Load SVG document without throwing on malformed input.
+	 * Same as try_load(utki::span<const char>).
+	 * @param buf - input buffer to load SVG from.
+	 * @return loaded document or error description, and loading statistics.
+	 */
+	load_result try_load(utki::span<const uint8_t> buf);
+};
+
+class visitor;
+
+/**
+ * @brief Parse SVG document in streaming mode.
+ * The document tree is not built. Instead, each element is passed to the visitor
+ * right after its closing tag is parsed, and is destroyed after that.
+ * So, the memory used does not depend on the size of the document, only on its nesting depth.
+ * Since the children are visited before their parent, container elements are visited with no children.
+ * Only elements which would be present in the document tree returned by load() are visited.
+ * The visitor is allowed to move data out of the visited elements.
+ * @param f - file interface to load SVG from.
+ * @param v - visitor to pass the parsed elements to.
+ * @throw malformed_svg_error - in case the document has structural errors.
+ * @throw std::invalid_argument - in case the document has unclosed XML tags.
+ */
+void stream(const fsif::file& f, visitor& v);
+
+/**
+ * @brief Parse SVG document in streaming mode.
+ * Same as stream(const fsif::file&, visitor&).
+ * @param s - input stream to load SVG from.
+ * @param v - visitor to pass the parsed elements to.
+ */
+void stream(std::istream& s, visitor& v);
+
+/**
+ * @brief Parse SVG document in streaming mode.
+ * Same as stream(const fsif::file&, visitor&).
+ * @param s - input string to load SVG from.
+ * @param v - visitor to pass the parsed elements to.
+ */
+void stream(std::string_view s, visitor& v);
+
+/**
+ * @brief Parse SVG document in streaming mode.
+ * Same as stream(const fsif::file&, visitor&).
+ * @param buf - input buffer to load SVG from.
+ * @param v - visitor to pass the parsed elements to.
+ */
+void stream(utki::span<const char> buf, visitor& v);
+
+/**
+ * @brief Parse SVG document in streaming mode.
+ * Same as stream(const fsif::file&, visitor&).
+ * @param buf - input buffer to load SVG from.
+ * @param v - visitor to pass the parsed elements to.
+ */
+void stream(utki::span<const uint8_t> buf, visitor& v);
+
 } // namespace svgdom
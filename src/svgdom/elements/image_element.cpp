@@ -27,6 +27,12 @@ SOFTWARE.
 
 #include "image_element.hpp"
 
+#include <algorithm>
+#include <cctype>
+
+#include <utki/span.hpp>
+#include <utki/util.hpp>
+
 #include "../visitor.hpp"
 
 using namespace svgdom;
@@ -40,3 +46,206 @@ void image_element::accept(const_visitor& v) const
 {
 	v.visit(*this);
 }
+
+namespace {
+constexpr unsigned invalid_digit = ~0u;
+
+unsigned base64_digit_value(char c) noexcept
+{
+	constexpr unsigned num_letters = 'Z' - 'A' + 1;
+	constexpr unsigned plus_value = num_letters * 2 + utki::to_int(utki::integer_base::dec);
+	constexpr unsigned slash_value = plus_value + 1;
+
+	if ('A' <= c && c <= 'Z') {
+		return unsigned(c - 'A');
+	}
+	if ('a' <= c && c <= 'z') {
+		return num_letters + unsigned(c - 'a');
+	}
+	if ('0' <= c && c <= '9') {
+		return num_letters * 2 + unsigned(c - '0');
+	}
+	if (c == '+' || c == '-') {
+		// '-' and '_' are the URL safe variants of '+' and '/'
+		return plus_value;
+	}
+	if (c == '/' || c == '_') {
+		return slash_value;
+	}
+	return invalid_digit;
+}
+
+std::optional<std::vector<uint8_t>> decode_base64(std::string_view str)
+{
+	constexpr unsigned digit_bits = 6;
+	constexpr unsigned digits_per_quantum = 4;
+
+	std::vector<uint8_t> ret;
+	ret.reserve(str.size() / digits_per_quantum * 3);
+
+	uint32_t quantum = 0;
+	unsigned num_digits = 0;
+
+	for (char c : str) {
+		if (c == '=') {
+			// padding
+			break;
+		}
+		if (std::isspace(static_cast<unsigned char>(c))) {
+			// line breaks are common in long attribute values
+			continue;
+		}
+
+		auto d = base64_digit_value(c);
+		if (d == invalid_digit) {
+			return {};
+		}
+
+		quantum = (quantum << digit_bits) | d;
+		++num_digits;
+
+		if (num_digits == digits_per_quantum) {
+			ret.push_back(uint8_t(quantum >> (utki::byte_bits * 2)));
+			ret.push_back(uint8_t(quantum >> utki::byte_bits));
+			ret.push_back(uint8_t(quantum));
+			quantum = 0;
+			num_digits = 0;
+		}
+	}
+
+	// incomplete last quantum
+	switch (num_digits) {
+		case 0:
+			break;
+		case 2:
+			ret.push_back(uint8_t(quantum >> (digit_bits * 2 - utki::byte_bits)));
+			break;
+		case 3:
+			ret.push_back(uint8_t(quantum >> (digit_bits * 3 - utki::byte_bits)));
+			ret.push_back(uint8_t(quantum >> (digit_bits * 3 - utki::byte_bits * 2)));
+			break;
+		default:
+			return {};
+	}
+
+	return ret;
+}
+
+std::string encode_base64(utki::span<const uint8_t> data)
+{
+	constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	constexpr unsigned digit_bits = 6;
+	constexpr unsigned digit_mask = (1 << digit_bits) - 1;
+	constexpr size_t bytes_per_quantum = 3;
+	constexpr size_t digits_per_quantum = 4;
+
+	std::string ret;
+	ret.reserve((data.size() + bytes_per_quantum - 1) / bytes_per_quantum * digits_per_quantum);
+
+	for (size_t i = 0; i < data.size(); i += bytes_per_quantum) {
+		size_t num_bytes = std::min(bytes_per_quantum, data.size() - i);
+
+		uint32_t quantum = 0;
+		for (size_t j = 0; j != bytes_per_quantum; ++j) {
+			quantum <<= utki::byte_bits;
+			if (j < num_bytes) {
+				quantum |= data[i + j];
+			}
+		}
+
+		for (size_t j = 0; j != digits_per_quantum; ++j) {
+			if (j <= num_bytes) {
+				ret.push_back(alphabet[(quantum >> (digit_bits * (digits_per_quantum - 1 - j))) & digit_mask]);
+			} else {
+				ret.push_back('=');
+			}
+		}
+	}
+
+	return ret;
+}
+
+unsigned hex_digit_value(char c) noexcept
+{
+	if ('0' <= c && c <= '9') {
+		return unsigned(c - '0');
+	}
+	if ('a' <= c && c <= 'f') {
+		return unsigned(utki::to_int(utki::integer_base::dec) + (c - 'a'));
+	}
+	if ('A' <= c && c <= 'F') {
+		return unsigned(utki::to_int(utki::integer_base::dec) + (c - 'A'));
+	}
+	return invalid_digit;
+}
+
+std::optional<std::vector<uint8_t>> decode_percent_encoded(std::string_view str)
+{
+	std::vector<uint8_t> ret;
+	ret.reserve(str.size());
+
+	for (size_t i = 0; i != str.size(); ++i) {
+		char c = str[i];
+		if (c != '%') {
+			ret.push_back(uint8_t(c));
+			continue;
+		}
+
+		if (str.size() - i <= 2) {
+			return {};
+		}
+
+		auto high = hex_digit_value(str[i + 1]);
+		auto low = hex_digit_value(str[i + 2]);
+		if (high == invalid_digit || low == invalid_digit) {
+			return {};
+		}
+
+		ret.push_back(uint8_t((high << utki::nibble_bits) | low));
+		i += 2;
+	}
+
+	return ret;
+}
+} // namespace
+
+std::optional<image_element::data_url> image_element::parse_data_url(std::string_view str)
+{
+	constexpr std::string_view scheme = "data:";
+	constexpr std::string_view base64_parameter = ";base64";
+
+	if (str.substr(0, scheme.size()) != scheme) {
+		return {};
+	}
+	str = str.substr(scheme.size());
+
+	auto comma = str.find(',');
+	if (comma == std::string_view::npos) {
+		return {};
+	}
+
+	auto media_type = str.substr(0, comma);
+	auto data = str.substr(comma + 1);
+
+	bool base64 = media_type.size() >= base64_parameter.size() &&
+		media_type.substr(media_type.size() - base64_parameter.size()) == base64_parameter;
+	if (base64) {
+		media_type = media_type.substr(0, media_type.size() - base64_parameter.size());
+	}
+
+	auto decoded = base64 ? decode_base64(data) : decode_percent_encoded(data);
+	if (!decoded) {
+		return {};
+	}
+
+	return data_url{std::string(media_type), std::move(decoded.value())};
+}
+
+std::string image_element::data_url::to_string() const
+{
+	std::string ret = "data:";
+	ret.append(this->media_type);
+	ret.append(";base64,");
+	ret.append(encode_base64(utki::make_span(this->data)));
+	return ret;
+}
@@ -27,6 +27,11 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "aspect_ratioed.hpp"
 #include "element.hpp"
 #include "rectangle.hpp"
@@ -45,6 +50,48 @@ struct image_element :
 	public rectangle,
 	public referencing,
 	public aspect_ratioed {
+	/**
+	 * @brief Decoded 'data:' URL.
+	 * See RFC 2397.
+	 */
+	struct data_url {
+		/**
+		 * @brief Media type with parameters, e.g. 'image/png'.
+		 * Empty if omitted in the URL.
+		 */
+		std::string media_type;
+
+		/**
+		 * @brief Decoded data.
+		 */
+		std::vector<uint8_t> data;
+
+		/**
+		 * @brief Convert to 'data:' URL string.
+		 * The data is always base64 encoded.
+		 * @return 'data:' URL string.
+		 */
+		std::string to_string() const;
+	};
+
+	/**
+	 * @brief Image embedded into the IRI.
+	 * Only filled in case the document is loaded with load_options::decode_data_urls set.
+	 * Then, if the IRI is a well-formed 'data:' URL, it is decoded and the IRI is cleared,
+	 * so that the image is not kept twice.
+	 * Empty otherwise, in that case the 'data:' URL, if any, is in the IRI as is.
+	 */
+	std::optional<data_url> data;
+
+	/**
+	 * @brief Parse 'data:' URL.
+	 * Both base64 and percent encoded URLs are supported.
+	 * @param str - string to parse.
+	 * @return decoded data URL.
+	 * @return empty optional in case the string is not a 'data:' URL or is malformed.
+	 */
+	static std::optional<data_url> parse_data_url(std::string_view str);
+
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
 
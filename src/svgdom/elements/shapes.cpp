@@ -27,11 +27,14 @@ SOFTWARE.
 
 #include "shapes.hpp"
 
+#include <array>
 #include <cctype>
+#include <limits>
 #include <sstream>
 
 #include <utki/debug.hpp>
 
+#include "../number_scanner.hxx"
 #include "../util.hxx"
 #include "../visitor.hpp"
 
@@ -127,125 +130,115 @@ decltype(path_element::path) path_element::parse(std::string_view str)
 {
 	decltype(path_element::path) ret;
 
-	try {
-		utki::string_parser p(str);
+	number_scanner p(str);
 
-		p.skip_whitespaces();
+	// reads number followed by optional separator
+	auto read = [&p](real& v) {
+		auto n = p.read_number();
+		if (!n) {
+			return false;
+		}
+		v = *n;
+		p.skip_whitespaces_and_comma();
+		return true;
+	};
+
+	// arc flags are single characters, can be written without separators
+	auto read_flag = [&p](bool& f) {
+		if (p.empty()) {
+			return false;
+		}
+		f = p.read_char() != '0';
+		p.skip_whitespaces_and_comma();
+		return true;
+	};
 
-		step::type cur_step_type = step::type::unknown;
-
-		while (!p.empty()) {
-			ASSERT(!utki::string_parser::is_space(p.peek_char())) // spaces should be skept
-
-			{
-				auto t = step::char_to_type(p.peek_char());
-				if (t != step::type::unknown) {
-					cur_step_type = t;
-					p.read_char();
-				} else if (cur_step_type == step::type::unknown) {
-					cur_step_type = step::type::move_abs;
-				} else if (cur_step_type == step::type::move_abs) {
-					cur_step_type = step::type::line_abs;
-				} else if (cur_step_type == step::type::move_rel) {
-					cur_step_type = step::type::line_rel;
-				}
-			}
+	p.skip_whitespaces();
 
-			p.skip_whitespaces();
-
-			step cur_step{};
-			cur_step.type_v = cur_step_type;
-
-			switch (cur_step.type_v) {
-				case step::type::move_abs:
-				case step::type::move_rel:
-				case step::type::line_abs:
-				case step::type::line_rel:
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::close:
-					break;
-				case step::type::horizontal_line_abs:
-				case step::type::horizontal_line_rel:
-					cur_step.x = p.read_number<real>();
-					break;
-				case step::type::vertical_line_abs:
-				case step::type::vertical_line_rel:
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::cubic_abs:
-				case step::type::cubic_rel:
-					cur_step.x1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::cubic_smooth_abs:
-				case step::type::cubic_smooth_rel:
-					cur_step.x2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y2 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::quadratic_abs:
-				case step::type::quadratic_rel:
-					cur_step.x1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y1 = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::quadratic_smooth_abs:
-				case step::type::quadratic_smooth_rel:
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				case step::type::arc_abs:
-				case step::type::arc_rel:
-					cur_step.rx() = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.ry() = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.x_axis_rotation() = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.flags.large_arc = (p.read_char() != '0');
-					p.skip_whitespaces_and_comma();
-					cur_step.flags.sweep = (p.read_char() != '0');
-					p.skip_whitespaces_and_comma();
-					cur_step.x = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					cur_step.y = p.read_number<real>();
-					break;
-				default:
-					ASSERT(false)
-					break;
+	step::type cur_step_type = step::type::unknown;
+
+	while (!p.empty()) {
+		ASSERT(!utki::string_parser::is_space(p.peek_char())) // spaces should be skept
+
+		{
+			auto t = step::char_to_type(p.peek_char());
+			if (t != step::type::unknown) {
+				cur_step_type = t;
+				p.read_char();
+			} else if (cur_step_type == step::type::unknown) {
+				cur_step_type = step::type::move_abs;
+			} else if (cur_step_type == step::type::move_abs) {
+				cur_step_type = step::type::line_abs;
+			} else if (cur_step_type == step::type::move_rel) {
+				cur_step_type = step::type::line_rel;
+			} else if (cur_step_type == step::type::close) {
+				// close path command has no arguments, so it cannot be repeated implicitly
+				break;
 			}
+		}
 
-			ret.push_back(cur_step);
+		p.skip_whitespaces();
+
+		step cur_step{};
+		cur_step.type_v = cur_step_type;
+
+		bool ok = true;
+
+		switch (cur_step.type_v) {
+			case step::type::move_abs:
+			case step::type::move_rel:
+			case step::type::line_abs:
+			case step::type::line_rel:
+				ok = read(cur_step.x) && read(cur_step.y);
+				break;
+			case step::type::close:
+				break;
+			case step::type::horizontal_line_abs:
+			case step::type::horizontal_line_rel:
+				ok = read(cur_step.x);
+				break;
+			case step::type::vertical_line_abs:
+			case step::type::vertical_line_rel:
+				ok = read(cur_step.y);
+				break;
+			case step::type::cubic_abs:
+			case step::type::cubic_rel:
+				ok = read(cur_step.x1) && read(cur_step.y1) && read(cur_step.x2) && read(cur_step.y2) &&
+					read(cur_step.x) && read(cur_step.y);
+				break;
+			case step::type::cubic_smooth_abs:
+			case step::type::cubic_smooth_rel:
+				ok = read(cur_step.x2) && read(cur_step.y2) && read(cur_step.x) && read(cur_step.y);
+				break;
+			case step::type::quadratic_abs:
+			case step::type::quadratic_rel:
+				ok = read(cur_step.x1) && read(cur_step.y1) && read(cur_step.x) && read(cur_step.y);
+				break;
+			case step::type::quadratic_smooth_abs:
+			case step::type::quadratic_smooth_rel:
+				ok = read(cur_step.x) && read(cur_step.y);
+				break;
+			case step::type::arc_abs:
+			case step::type::arc_rel:
+				ok = read(cur_step.rx()) && read(cur_step.ry()) && read(cur_step.x_axis_rotation()) &&
+					read_flag(cur_step.flags.large_arc) && read_flag(cur_step.flags.sweep) && read(cur_step.x) &&
+					read(cur_step.y);
+				break;
+			default:
+				ASSERT(false)
+				break;
+		}
 
-			p.skip_whitespaces_and_comma();
+		if (!ok) {
+			utki::log_debug([&](auto& o) {
+				o << "WARNING: path_element::parse(): malformed path data, ignored: " << p.get_view() << std::endl;
+			});
+			break;
 		}
-	} catch (std::invalid_argument& e) {
-		utki::log_debug([&](auto& o) {
-			o << "WARNING: path_element::parse(): std::invalid_argument exception caught, ignored." << '\n'
-			  << "  e.what() = " << e.what() << std::endl;
-		});
-		// ignore the exception
+
+		ret.push_back(cur_step);
+
+		p.skip_whitespaces_and_comma();
 	}
 
 	return ret;
@@ -403,79 +396,76 @@ char path_element::step::type_to_char(step::type t)
 	}
 }
 
+namespace {
+// path commands are single characters, so lookup table indexed by the character is a perfect hash
+constexpr auto char_to_step_type_map = []() {
+	using step = path_element::step;
+
+	std::array<step::type, std::numeric_limits<unsigned char>::max() + 1> ret{};
+	for (auto& t : ret) {
+		t = step::type::unknown;
+	}
+
+	ret['M'] = step::type::move_abs;
+	ret['m'] = step::type::move_rel;
+	ret['z'] = step::type::close;
+	ret['Z'] = step::type::close;
+	ret['L'] = step::type::line_abs;
+	ret['l'] = step::type::line_rel;
+	ret['H'] = step::type::horizontal_line_abs;
+	ret['h'] = step::type::horizontal_line_rel;
+	ret['V'] = step::type::vertical_line_abs;
+	ret['v'] = step::type::vertical_line_rel;
+	ret['C'] = step::type::cubic_abs;
+	ret['c'] = step::type::cubic_rel;
+	ret['S'] = step::type::cubic_smooth_abs;
+	ret['s'] = step::type::cubic_smooth_rel;
+	ret['Q'] = step::type::quadratic_abs;
+	ret['q'] = step::type::quadratic_rel;
+	ret['T'] = step::type::quadratic_smooth_abs;
+	ret['t'] = step::type::quadratic_smooth_rel;
+	ret['A'] = step::type::arc_abs;
+	ret['a'] = step::type::arc_rel;
+
+	return ret;
+}();
+} // namespace
+
 path_element::step::type path_element::step::char_to_type(char c)
 {
-	switch (c) {
-		case 'M':
-			return step::type::move_abs;
-		case 'm':
-			return step::type::move_rel;
-		case 'z':
-		case 'Z':
-			return step::type::close;
-		case 'L':
-			return step::type::line_abs;
-		case 'l':
-			return step::type::line_rel;
-		case 'H':
-			return step::type::horizontal_line_abs;
-		case 'h':
-			return step::type::horizontal_line_rel;
-		case 'V':
-			return step::type::vertical_line_abs;
-		case 'v':
-			return step::type::vertical_line_rel;
-		case 'C':
-			return step::type::cubic_abs;
-		case 'c':
-			return step::type::cubic_rel;
-		case 'S':
-			return step::type::cubic_smooth_abs;
-		case 's':
-			return step::type::cubic_smooth_rel;
-		case 'Q':
-			return step::type::quadratic_abs;
-		case 'q':
-			return step::type::quadratic_rel;
-		case 'T':
-			return step::type::quadratic_smooth_abs;
-		case 't':
-			return step::type::quadratic_smooth_rel;
-		case 'A':
-			return step::type::arc_abs;
-		case 'a':
-			return step::type::arc_rel;
-		default:
-			return step::type::unknown;
-	}
+	return char_to_step_type_map[uint8_t(c)];
 }
 
 decltype(polyline_shape::points) polyline_shape::parse(std::string_view s)
 {
 	decltype(polyline_shape::points) ret;
 
-	utki::string_parser p(s);
+	number_scanner p(s);
 
-	try {
-		while (!s.empty()) {
-			decltype(ret)::value_type point;
+	p.skip_whitespaces();
 
-			point[0] = p.read_number<real>();
+	while (!p.empty()) {
+		auto x = p.read_number();
+		if (!x) {
+			break;
+		}
 
-			p.skip_whitespaces_and_comma();
+		p.skip_whitespaces_and_comma();
 
-			point[1] = p.read_number<real>();
+		auto y = p.read_number();
+		if (!y) {
+			break;
+		}
 
-			ret.push_back(point);
+		ret.push_back({x.value(), y.value()});
 
-			p.skip_whitespaces_and_comma();
-		}
-	} catch (std::invalid_argument& e) {
+		p.skip_whitespaces_and_comma();
+	}
+
+	if (!p.empty()) {
 		utki::log_debug([&](auto& o) {
-			o << "WARNING: polyline_shape::parse(): std::invalid_argument exception caught, ignored." << '\n'
-			  << "  e.what() = " << e.what() << std::endl;
+			o << "WARNING: polyline_shape::parse(): malformed points data, ignored: " << p.get_view() << std::endl;
 		});
-		// ignore the exception
 	}
 
 	return ret;
@@ -27,6 +27,9 @@ SOFTWARE.
 
 #include "style.hpp"
 
+#include <atomic>
+
+#include "../util/css_index.hpp"
 #include "../visitor.hpp"
 
 using namespace svgdom;
@@ -40,3 +43,24 @@ void style_element::accept(const_visitor& v) const
 {
 	v.visit(*this);
 }
+
+std::shared_ptr<const css_index> style_element::get_css_index() const
+{
+	auto ret = std::atomic_load(&this->css_index_v);
+	if (ret) {
+		return ret;
+	}
+
+	// several threads might build the index at the same time, in that case any of the built indices is kept
+	ret = std::make_shared<css_index>(this->css);
+	std::shared_ptr<const css_index> expected;
+	if (!std::atomic_compare_exchange_strong(&this->css_index_v, &expected, ret)) {
+		return expected;
+	}
+	return ret;
+}
+
+void style_element::invalidate_css_index() noexcept
+{
+	std::atomic_store(&this->css_index_v, std::shared_ptr<const css_index>());
+}
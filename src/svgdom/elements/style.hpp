@@ -27,6 +27,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <cssom/om.hpp>
@@ -38,6 +39,8 @@ namespace svgdom {
 
 using namespace std::string_view_literals;
 
+class css_index;
+
 // TODO: why lint complains here on macos?
 // NOLINTNEXTLINE(bugprone-exception-escape, "error: an exception may be thrown in function")
 struct style_element : public element {
@@ -49,6 +52,22 @@ struct style_element : public element {
 
 	constexpr static std::string_view tag = "style"sv;
 
+	/**
+	 * @brief Get index of the CSS rules.
+	 * The index is built on first call and is reused by the subsequent calls,
+	 * so that the CSS of the document is indexed only once for all style stacks and computed styles.
+	 * It is safe to call this function from several threads at the same time.
+	 * @return index of the css sheet.
+	 */
+	std::shared_ptr<const css_index> get_css_index() const;
+
+	/**
+	 * @brief Drop the index of the CSS rules.
+	 * Has to be called after the css sheet is modified, so that the index is rebuilt on next get_css_index() call.
+	 * Those who already got the old index can keep using it, it remains valid, but reflects the old sheet.
+	 */
+	void invalidate_css_index() noexcept;
+
 	std::string_view get_tag() const override
 	{
 		return tag;
@@ -56,6 +75,10 @@ struct style_element : public element {
 
 	void accept(visitor& v) override;
 	void accept(const_visitor& v) const override;
+
+private:
+	// accessed only with std::atomic_load() and std::atomic_store()
+	mutable std::shared_ptr<const css_index> css_index_v;
 };
 
 } // namespace svgdom
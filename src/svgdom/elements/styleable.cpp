@@ -27,17 +27,22 @@ SOFTWARE.
 
 #include "styleable.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cctype>
 #include <cmath>
 #include <iomanip>
+#include <map>
+#include <optional>
 #include <ratio>
 #include <set>
+#include <stdexcept>
 
 #include <utki/debug.hpp>
 #include <utki/util.hpp>
 
-#include "../malformed_svg_error.hpp"
+#include "../number_scanner.hxx"
+#include "../perfect_hash.hxx"
 #include "../util.hxx"
 
 #include "element.hpp"
@@ -223,6 +228,76 @@ std::string styleable::style_value_to_string(style_property p, const style_value
 	return s.str();
 }
 
+size_t style_map::index_of(style_property p) const noexcept
+{
+	return count_bits(this->presence & (bit(p) - 1));
+}
+
+style_map::iterator style_map::find(style_property p) noexcept
+{
+	if (!(this->presence & bit(p))) {
+		return this->end();
+	}
+	return std::next(this->begin(), std::ptrdiff_t(this->index_of(p)));
+}
+
+style_map::const_iterator style_map::find(style_property p) const noexcept
+{
+	if (!(this->presence & bit(p))) {
+		return this->end();
+	}
+	return std::next(this->begin(), std::ptrdiff_t(this->index_of(p)));
+}
+
+const style_value& style_map::at(style_property p) const
+{
+	auto i = this->find(p);
+	if (i == this->end()) {
+		throw std::out_of_range("style_map::at(): property is not present");
+	}
+	return i->second;
+}
+
+std::pair<style_map::iterator, bool> style_map::emplace(style_property p, style_value v)
+{
+	auto i = std::next(this->entries.begin(), std::ptrdiff_t(this->index_of(p)));
+	if (this->presence & bit(p)) {
+		return {i, false};
+	}
+	i = this->entries.emplace(i, p, std::move(v));
+	this->presence |= bit(p);
+	return {i, true};
+}
+
+std::pair<style_map::iterator, bool> style_map::insert_or_assign(style_property p, style_value v)
+{
+	auto i = std::next(this->entries.begin(), std::ptrdiff_t(this->index_of(p)));
+	if (this->presence & bit(p)) {
+		i->second = std::move(v);
+		return {i, false};
+	}
+	i = this->entries.emplace(i, p, std::move(v));
+	this->presence |= bit(p);
+	return {i, true};
+}
+
+size_t style_map::erase(style_property p)
+{
+	auto i = this->find(p);
+	if (i == this->end()) {
+		return 0;
+	}
+	this->erase(i);
+	return 1;
+}
+
+style_map::iterator style_map::erase(const_iterator i)
+{
+	ASSERT(this->presence & bit(i->first))
+	this->presence &= ~bit(i->first);
+	return this->entries.erase(i);
+}
+
 std::string styleable::styles_to_string() const
 {
 	std::stringstream s;
@@ -276,10 +351,12 @@ style_value styleable::parse_style_property_value(style_property type, std::stri
 			return parse_color_interpolation(str);
 		case style_property::stroke_miterlimit:
 			{
-				real miter_limit = utki::string_parser(str).read_number<real>();
+				auto miter_limit = number_scanner(str).read_number();
+				if (!miter_limit) {
+					return {};
+				}
 				using std::max;
-				miter_limit = max(miter_limit, real(1)); // minimal value is 1
-				return {miter_limit};
+				return {max(miter_limit.value(), real(1))}; // minimal value is 1
 			}
 			break;
 		case style_property::stop_opacity:
@@ -287,11 +364,13 @@ style_value styleable::parse_style_property_value(style_property type, std::stri
 		case style_property::stroke_opacity:
 		case style_property::fill_opacity:
 			{
-				real opacity = utki::string_parser(str).read_number<real>();
+				auto opacity = number_scanner(str).read_number();
+				if (!opacity) {
+					return {};
+				}
 				using std::min;
 				using std::max;
-				opacity = max(real(0), min(opacity, real(1))); // clamp to [0:1]
-				return {opacity};
+				return {max(real(0), min(opacity.value(), real(1)))}; // clamp to [0:1]
 			}
 			break;
 		case style_property::stop_color:
@@ -373,7 +452,7 @@ style_value svgdom::parse_url(std::string_view str)
 	auto url = p.read_word_until(')');
 
 	p.skip_whitespaces();
-	if (p.read_char() == ')') {
+	if (!p.empty() && p.read_char() == ')') {
 		return {std::string(url)};
 	}
 
@@ -419,7 +498,7 @@ decltype(styleable::styles) styleable::parse(const std::string& str)
 
 		p.skip_whitespaces();
 
-		if (p.read_char() != ':') {
+		if (p.empty() || p.read_char() != ':') {
 			return ret; // expected colon
 		}
 
@@ -468,7 +547,7 @@ bool styleable::is_inheritable(style_property p)
 }
 
 namespace {
-const std::map<std::string_view, style_property> string_to_property_map = {
+constexpr auto string_to_property_map = make_perfect_hash_map<style_property>({
 	{		  "alignment-baseline",           style_property::alignment_baseline},
 	{			  "baseline-shift",               style_property::baseline_shift},
 	{						"clip",						 style_property::clip},
@@ -530,18 +609,23 @@ const std::map<std::string_view, style_property> string_to_property_map = {
 	{				  "visibility",				   style_property::visibility},
 	{				"word-spacing",                 style_property::word_spacing},
 	{				"writing-mode",                 style_property::writing_mode}
-};
+});
 } // namespace
 
 namespace {
-const auto property_to_string_map = utki::flip_map(string_to_property_map);
+constexpr auto property_to_string_map = []() {
+	std::array<std::string_view, size_t(style_property::enum_size)> ret{};
+	for (const auto& e : string_to_property_map) {
+		ret[size_t(e.value)] = e.key;
+	}
+	return ret;
+}();
 } // namespace
 
 style_property styleable::string_to_property(std::string_view str)
 {
-	auto i = string_to_property_map.find(str);
-	if (i != string_to_property_map.end()) {
-		return i->second;
+	if (auto p = string_to_property_map.find(str)) {
+		return *p;
 	}
 
 	return style_property::unknown;
@@ -549,9 +633,8 @@ style_property styleable::string_to_property(std::string_view str)
 
 std::string_view styleable::property_to_string(style_property p)
 {
-	auto i = property_to_string_map.find(p);
-	if (i != property_to_string_map.end()) {
-		return i->second;
+	if (size_t(p) < property_to_string_map.size()) {
+		return property_to_string_map[size_t(p)];
 	}
 	return {};
 }
@@ -603,7 +686,7 @@ style_value svgdom::make_style_value(const r4::vector3<real>& rgb)
 }
 
 namespace {
-const std::map<std::string_view, uint32_t> color_name_to_color_map = {
+constexpr auto color_name_to_color_map = make_perfect_hash_map<uint32_t>({
 	{		   "aliceblue"sv, 0xfff8f0},
 	{		"antiquewhite"sv, 0xd7ebfa},
 	{				"aqua"sv, 0xffff00},
@@ -674,7 +757,7 @@ const std::map<std::string_view, uint32_t> color_name_to_color_map = {
 	{		   "lightblue"sv, 0xe6d8ad},
 	{		  "lightcoral"sv, 0x8080f0},
 	{		   "lightcyan"sv, 0xffffe0},
-	{"lightgoldenrodyellowsv", 0xd2fafa},
+	{"lightgoldenrodyellow"sv, 0xd2fafa},
 	{		   "lightgray"sv, 0xd3d3d3},
 	{		  "lightgreen"sv, 0x90ee90},
 	{		   "lightgrey"sv, 0xd3d3d3},
@@ -691,13 +774,13 @@ const std::map<std::string_view, uint32_t> color_name_to_color_map = {
 	{			   "linen"sv, 0xe6f0fa},
 	{			 "magenta"sv, 0xff00ff},
 	{			  "maroon"sv,     0x80},
-	{    "mediumaquamarinesv", 0xaacd66},
+	{    "mediumaquamarine"sv, 0xaacd66},
 	{		  "mediumblue"sv, 0xcd0000},
 	{		"mediumorchid"sv, 0xd355ba},
 	{		"mediumpurple"sv, 0xdb7093},
 	{	  "mediumseagreen"sv, 0x71b33c},
 	{	 "mediumslateblue"sv, 0xee687b},
-	{   "mediumspringgreensv", 0x9afa00},
+	{   "mediumspringgreen"sv, 0x9afa00},
 	{	 "mediumturquoise"sv, 0xccd148},
 	{	 "mediumvioletred"sv, 0x8515c7},
 	{		"midnightblue"sv, 0x701919},
@@ -751,15 +834,22 @@ const std::map<std::string_view, uint32_t> color_name_to_color_map = {
 	{		  "whitesmoke"sv, 0xf5f5f5},
 	{			  "yellow"sv,   0xffff},
 	{		 "yellowgreen"sv, 0x32cd9a}
-};
+});
 } // namespace
 
 namespace {
-const auto color_to_color_name_map = utki::flip_map(color_name_to_color_map);
+const auto color_to_color_name_map = []() {
+	std::map<uint32_t, std::string_view> ret;
+	for (const auto& e : color_name_to_color_map) {
+		// some colors have several names, e.g. 'aqua' and 'cyan', use the first one
+		ret.insert(std::make_pair(e.value, e.key));
+	}
+	return ret;
+}();
 } // namespace
 
 namespace {
-const std::map<std::string_view, display> string_to_display_map = {
+constexpr auto string_to_display_map = make_perfect_hash_map<display>({
 	{			"inline",     svgdom::display::inline_display},
 	{			 "block",			  svgdom::display::block},
 	{		 "list-item",          svgdom::display::list_item},
@@ -777,85 +867,85 @@ const std::map<std::string_view, display> string_to_display_map = {
 	{		"table-cell",         svgdom::display::table_cell},
 	{	 "table-caption",      svgdom::display::table_caption},
 	{		   none_word,               svgdom::display::none}
-};
+});
 } // namespace
 
 namespace {
-const auto display_to_string_map = utki::flip_map(string_to_display_map);
+constexpr auto display_to_string_map = []() {
+	std::array<std::string_view, size_t(svgdom::display::none) + 1> ret{};
+	for (const auto& e : string_to_display_map) {
+		ret[size_t(e.value)] = e.key;
+	}
+	return ret;
+}();
 } // namespace
 
 style_value svgdom::parse_display(std::string_view& str)
 {
 	// NOTE: "inherit" is already checked on upper level.
 
-	auto i = string_to_display_map.find(str);
-	if (i == string_to_display_map.end()) {
-		return {svgdom::display::inline_display}; // default value
-	} else {
-		return {i->second};
+	if (auto d = string_to_display_map.find(str)) {
+		return {*d};
 	}
+	return {svgdom::display::inline_display}; // default value
 }
 
 std::string_view svgdom::display_to_string(const style_value& v)
 {
-	const auto& default_value = []() {
-		auto i = display_to_string_map.find(svgdom::display::inline_display);
-		ASSERT(i != display_to_string_map.end())
-		return i->second;
-	}();
+	constexpr auto default_value = display_to_string_map[size_t(svgdom::display::inline_display)];
 
 	if (!std::holds_alternative<svgdom::display>(v)) {
 		return default_value;
 	}
 
-	auto i = display_to_string_map.find(*std::get_if<svgdom::display>(&v));
-	if (i == display_to_string_map.end()) {
+	auto i = size_t(*std::get_if<svgdom::display>(&v));
+	if (i >= display_to_string_map.size()) {
 		return default_value;
 	}
-	return i->second;
+	return display_to_string_map[i];
 }
 
 namespace {
-const std::map<std::string_view, visibility> string_to_visibility_map = {
+constexpr auto string_to_visibility_map = make_perfect_hash_map<visibility>({
 	{ "visible",  visibility::visible},
 	{  "hidden",   visibility::hidden},
 	{"collapse", visibility::collapse}
-};
+});
 } // namespace
 
 namespace {
-const auto visibility_to_string_map = utki::flip_map(string_to_visibility_map);
+constexpr auto visibility_to_string_map = []() {
+	std::array<std::string_view, size_t(svgdom::visibility::collapse) + 1> ret{};
+	for (const auto& e : string_to_visibility_map) {
+		ret[size_t(e.value)] = e.key;
+	}
+	return ret;
+}();
 } // namespace
 
 style_value svgdom::parse_visibility(std::string_view str)
 {
 	// NOTE: "inherit" is already checked on upper level.
 
-	auto i = string_to_visibility_map.find(str);
-	if (i == string_to_visibility_map.end()) {
-		return {svgdom::visibility::visible}; // default value
-	} else {
-		return {i->second};
+	if (auto vis = string_to_visibility_map.find(str)) {
+		return {*vis};
 	}
+	return {svgdom::visibility::visible}; // default value
 }
 
 std::string_view svgdom::visibility_to_string(const style_value& v)
 {
-	const auto& default_value = []() {
-		auto i = visibility_to_string_map.find(svgdom::visibility::visible);
-		ASSERT(i != visibility_to_string_map.end())
-		return i->second;
-	}();
+	constexpr auto default_value = visibility_to_string_map[size_t(svgdom::visibility::visible)];
 
 	if (!std::holds_alternative<svgdom::visibility>(v)) {
 		return default_value;
 	}
 
-	auto i = visibility_to_string_map.find(*std::get_if<svgdom::visibility>(&v));
-	if (i == visibility_to_string_map.end()) {
+	auto i = size_t(*std::get_if<svgdom::visibility>(&v));
+	if (i >= visibility_to_string_map.size()) {
 		return default_value;
 	}
-	return i->second;
+	return visibility_to_string_map[i];
 }
 
 style_value svgdom::parse_color_interpolation(std::string_view str)
@@ -900,29 +990,32 @@ std::string svgdom::color_interpolation_filters_to_string(const style_value& v)
 }
 
 namespace {
-decltype(enable_background_property::rect) parse_enable_background_new_rect(std::string_view str)
+std::optional<decltype(enable_background_property::rect)> parse_enable_background_new_rect(std::string_view str)
 {
-	try {
-		utki::string_parser p(str);
-		p.skip_inclusive_until(' '); // skip 'new'
-
-		p.skip_whitespaces();
+	number_scanner p(str);
+	p.read_word(); // skip 'new'
 
-		if (p.empty()) {
-			// indicate that rectangle is not specified
-			return {
-				{-1, -1},
-				{-1, -1}
-			};
-		}
+	p.skip_whitespaces();
 
+	if (p.empty()) {
+		// indicate that rectangle is not specified
 		return {
-			{p.read_number<real>(), p.read_number<real>()},
-			{p.read_number<real>(), p.read_number<real>()}
+			{{-1, -1}, {-1, -1}}
 		};
-	} catch (std::invalid_argument&) {
-		throw malformed_svg_error("malformed enable-background NEW string");
 	}
+
+	std::array<real, 4> values{};
+	for (auto& v : values) {
+		auto n = p.read_number();
+		if (!n) {
+			return {};
+		}
+		v = n.value();
+	}
+
+	return {
+		{{values[0], values[1]}, {values[2], values[3]}}
+	};
 }
 } // namespace
 
@@ -930,15 +1023,13 @@ style_value svgdom::parse_enable_background(std::string_view str)
 {
 	constexpr auto default_value = svgdom::enable_background::accumulate;
 
-	std::string new_str = "new";
+	constexpr std::string_view new_str = "new";
 	if (str.substr(0, new_str.length()) == new_str) {
-		try {
+		if (auto rect = parse_enable_background_new_rect(str)) {
 			return enable_background_property{
 				svgdom::enable_background::new_background,
-				parse_enable_background_new_rect(str)
+				rect.value()
 			};
-		} catch (malformed_svg_error&) {
-			return enable_background_property{default_value};
 		}
 	}
 
@@ -1034,6 +1125,90 @@ uint32_t hsl_to_rgb(real h, real s, real l)
 } // namespace
 
 // 'str' should have no leading and/or trailing white spaces.
+namespace {
+// parses arguments of rgb() color function, including closing parenthesis
+std::optional<uint32_t> parse_rgb_function_arguments(std::string_view args)
+{
+	// rgb() color values are given either all as percentages or all as absolute values
+	auto first_separator = args.find_first_of(",%");
+	if (first_separator == std::string_view::npos) {
+		return {};
+	}
+	bool percent = args[first_separator] == '%';
+
+	number_scanner p(args);
+
+	uint32_t color = 0;
+
+	for (unsigned i = 0; i != 3; ++i) {
+		auto n = p.read_number();
+		if (!n) {
+			return {};
+		}
+
+		real c = n.value();
+
+		if (percent) {
+			p.skip_whitespaces();
+			if (p.read_char() != '%') {
+				return {};
+			}
+			c = c * utki::byte_mask / std::centi::den;
+		}
+
+		color |= uint32_t(std::clamp(c, real(0), real(utki::byte_mask))) << (utki::byte_bits * i);
+
+		p.skip_whitespaces_and_comma();
+	}
+
+	if (p.read_char() != ')') {
+		// no expected closing ')'
+		return {};
+	}
+
+	return color;
+}
+} // namespace
+
+namespace {
+// parses arguments of hsl() color function, including closing parenthesis
+std::optional<uint32_t> parse_hsl_function_arguments(std::string_view args)
+{
+	number_scanner p(args);
+
+	auto h = p.read_number();
+	if (!h) {
+		return {};
+	}
+
+	p.skip_whitespaces_and_comma();
+
+	auto s = p.read_number();
+	if (!s || p.read_char() != '%') {
+		return {};
+	}
+
+	p.skip_whitespaces_and_comma();
+
+	auto l = p.read_number();
+	if (!l || p.read_char() != '%') {
+		return {};
+	}
+
+	p.skip_whitespaces();
+
+	if (p.read_char() != ')') {
+		return {};
+	}
+
+	return hsl_to_rgb( //
+		h.value(),
+		s.value() / real(std::centi::den),
+		l.value() / real(std::centi::den)
+	);
+}
+} // namespace
+
 style_value svgdom::parse_paint(std::string_view str)
 {
 	// TRACE(<< "parse_paint(): str = " << str << std::endl)
@@ -1124,80 +1299,13 @@ style_value svgdom::parse_paint(std::string_view str)
 		}
 	}
 
-	// check if rgb() or RGB() notation
+	// check if rgb() notation
 	{
-		const static std::string rgb_word = "rgb("s;
+		constexpr std::string_view rgb_word = "rgb(";
 
-		utki::string_parser p(str);
-
-		if (rgb_word == p.read_chars(rgb_word.size())) {
-			switch (utki::string_parser(p.get_view()).skip_inclusive_until_one_of(",%")) {
-				// rgb() color values are given as percentages
-				case '%':
-					{
-						p.skip_whitespaces();
-						auto r = p.read_number<float>();
-						p.skip_whitespaces();
-						if (p.read_char() != '%') {
-							utki::assert(false, SL);
-							break;
-						}
-						p.skip_whitespaces_and_comma();
-						auto g = p.read_number<float>();
-						p.skip_whitespaces();
-						if (p.read_char() != '%') {
-							utki::assert(false, SL);
-							break;
-						}
-						p.skip_whitespaces_and_comma();
-						auto b = p.read_number<float>();
-						p.skip_whitespaces();
-						if (p.read_char() != '%') {
-							utki::assert(
-								false,
-								[&](auto& o) {
-									o << "str = " << str;
-								},
-								SL
-							);
-							break;
-						}
-						p.skip_whitespaces();
-
-						if (p.read_char() != ')') {
-							// no expected closing ')'
-							break;
-						}
-
-						// std::cout << "r = " << r << ", g = " << g << ", b = " << b << std::endl;
-						auto color = uint32_t(r * utki::byte_mask / std::centi::den) |
-							(uint32_t(g * utki::byte_mask / std::centi::den) << utki::byte_bits) |
-							(uint32_t(b * utki::byte_mask / std::centi::den) << (utki::byte_bits * 2));
-						return {color};
-					}
-				// rgb() color values are given as absolute values
-				case ',':
-					{
-						p.skip_whitespaces();
-						auto r = p.read_number<uint32_t>();
-						p.skip_whitespaces_and_comma();
-						auto g = p.read_number<uint32_t>();
-						p.skip_whitespaces_and_comma();
-						auto b = p.read_number<uint32_t>();
-						p.skip_whitespaces();
-
-						if (p.read_char() != ')') {
-							// no expected closing ')'
-							break;
-						}
-
-						auto color = r | (g << utki::byte_bits) | (b << (utki::byte_bits * 2));
-						return {color};
-					}
-				// malformed rgb() paint specification
-				default:
-					utki::assert(false, SL);
-					break;
+		if (str.substr(0, rgb_word.size()) == rgb_word) {
+			if (auto color = parse_rgb_function_arguments(str.substr(rgb_word.size()))) {
+				return {color.value()};
 			}
 			return {style_value_special::none};
 		}
@@ -1205,32 +1313,11 @@ style_value svgdom::parse_paint(std::string_view str)
 
 	// check if hsl() notation
 	{
-		const static std::string hsl_word = "hsl("s;
-
-		utki::string_parser p(str);
-
-		if (hsl_word == p.read_chars(hsl_word.size())) {
-			p.skip_whitespaces();
-			auto h = p.read_number<uint32_t>();
-			p.skip_whitespaces_and_comma();
-			auto s = p.read_number<uint32_t>();
-			if (p.read_char() != '%') {
-				return {style_value_special::none};
-			}
-			p.skip_whitespaces_and_comma();
-			auto l = p.read_number<uint32_t>();
-			if (p.read_char() != '%') {
-				return {style_value_special::none};
-			}
-			p.skip_whitespaces();
+		constexpr std::string_view hsl_word = "hsl(";
 
-			if (p.read_char() == ')') {
-				auto color = hsl_to_rgb( //
-					real(h),
-					real(s) / real(std::centi::den),
-					real(l) / real(std::centi::den)
-				);
-				return {color};
+		if (str.substr(0, hsl_word.size()) == hsl_word) {
+			if (auto color = parse_hsl_function_arguments(str.substr(hsl_word.size()))) {
+				return {color.value()};
 			}
 			return {style_value_special::none};
 		}
@@ -1241,10 +1328,8 @@ style_value svgdom::parse_paint(std::string_view str)
 		utki::string_parser p(str);
 		auto name = p.read_word();
 
-		auto i = color_name_to_color_map.find(name);
-		if (i != color_name_to_color_map.end()) {
-			utki::assert(i->first == name, SL);
-			return {i->second};
+		if (auto c = color_name_to_color_map.find(name)) {
+			return {*c};
 		}
 	}
 
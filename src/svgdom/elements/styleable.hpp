@@ -27,13 +27,15 @@ SOFTWARE.
 
 #pragma once
 
-#include <map>
+#include <cstdint>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include <cssom/om.hpp>
 #include <r4/rectangle.hpp>
 #include <r4/vector.hpp>
+#include <utki/debug.hpp>
 
 #include "../config.hpp"
 #include "../length.hpp"
@@ -175,6 +177,16 @@ struct enable_background_property {
 	{
 		return this->rect.d.x() >= 0 && this->rect.d.y() >= 0;
 	}
+
+	bool operator==(const enable_background_property& p) const
+	{
+		return this->value == p.value && this->rect.p == p.rect.p && this->rect.d == p.rect.d;
+	}
+
+	bool operator!=(const enable_background_property& p) const
+	{
+		return !this->operator==(p);
+	}
 };
 
 enum class style_value_special {
@@ -232,6 +244,14 @@ inline bool is_current_color(const style_value& v)
  */
 std::string get_local_id_from_iri(const style_value& v);
 
+/**
+ * @brief Parse paint value.
+ * Components of rgb() colors can be real numbers, they are clamped to [0:255],
+ * or to [0%:100%] in case of percentages, and truncated to integer.
+ * @param str - string to parse, without leading and trailing whitespaces.
+ * @return parsed paint value.
+ * @return 'none' in case the string is a malformed rgb() or hsl() color.
+ */
 style_value parse_paint(std::string_view str);
 std::string paint_to_string(const style_value& v);
 
@@ -273,12 +293,171 @@ style_value make_style_value(uint8_t r, uint8_t g, uint8_t b);
  */
 style_value make_style_value(const r4::vector3<real>& rgb);
 
+/**
+ * @brief Compact map from style property to its value.
+ * Has the same API as std::map<style_property, style_value>, but stores the entries in a single
+ * array sorted by property, and uses a bitmap of present properties for lookups.
+ * So, the lookup is a bit test and counting of bits below the property's bit,
+ * and an element with a couple of properties takes one small allocation.
+ * As with std::map, the entries are iterated in the order of style_property enumeration.
+ * Unlike with std::map, the keys of the entries are not const, but must not be modified through the iterators,
+ * and insertion or erasure of entries invalidates all iterators and references to the entries.
+ */
+class style_map
+{
+public:
+	using key_type = style_property;
+	using mapped_type = style_value;
+	using value_type = std::pair<style_property, style_value>;
+	using size_type = size_t;
+
+private:
+	static_assert(size_t(style_property::enum_size) <= 64, "style properties do not fit into 64-bit bitmap");
+
+	// bit number N is set in case the property with value N is present
+	uint64_t presence = 0;
+
+	std::vector<value_type> entries;
+
+	static uint64_t bit(style_property p) noexcept
+	{
+		ASSERT(size_t(p) < size_t(style_property::enum_size))
+		return uint64_t(1) << size_t(p);
+	}
+
+	// index of the property's entry, or of the place to insert the entry to
+	size_t index_of(style_property p) const noexcept;
+
+public:
+	using iterator = decltype(entries)::iterator;
+	using const_iterator = decltype(entries)::const_iterator;
+
+	size_t size() const noexcept
+	{
+		return this->entries.size();
+	}
+
+	bool empty() const noexcept
+	{
+		return this->entries.empty();
+	}
+
+	void clear() noexcept
+	{
+		this->presence = 0;
+		this->entries.clear();
+	}
+
+	iterator begin() noexcept
+	{
+		return this->entries.begin();
+	}
+
+	iterator end() noexcept
+	{
+		return this->entries.end();
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return this->entries.begin();
+	}
+
+	const_iterator end() const noexcept
+	{
+		return this->entries.end();
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+		return this->entries.cbegin();
+	}
+
+	const_iterator cend() const noexcept
+	{
+		return this->entries.cend();
+	}
+
+	size_t count(style_property p) const noexcept
+	{
+		return (this->presence & bit(p)) ? 1 : 0;
+	}
+
+	iterator find(style_property p) noexcept;
+
+	const_iterator find(style_property p) const noexcept;
+
+	/**
+	 * @brief Get property value.
+	 * @param p - property to get value of.
+	 * @return value of the property.
+	 * @throw std::out_of_range - in case the property is not present.
+	 */
+	const style_value& at(style_property p) const;
+
+	/**
+	 * @brief Get property value.
+	 * @param p - property to get value of.
+	 * @return value of the property.
+	 * @throw std::out_of_range - in case the property is not present.
+	 */
+	style_value& at(style_property p)
+	{
+		return const_cast<style_value&>(std::as_const(*this).at(p)); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+	}
+
+	/**
+	 * @brief Get property value, inserting the property if not present.
+	 * @param p - property to get value of.
+	 * @return value of the property.
+	 */
+	style_value& operator[](style_property p)
+	{
+		return this->emplace(p, style_value()).first->second;
+	}
+
+	/**
+	 * @brief Insert property unless it is already present.
+	 * @param p - property to insert.
+	 * @param v - value of the property.
+	 * @return pair of iterator to the entry of the property and flag, true if the property was inserted.
+	 */
+	std::pair<iterator, bool> emplace(style_property p, style_value v);
+
+	std::pair<iterator, bool> insert(value_type entry)
+	{
+		return this->emplace(entry.first, std::move(entry.second));
+	}
+
+	/**
+	 * @brief Insert property or assign to the existing one.
+	 * @param p - property to insert or assign.
+	 * @param v - value of the property.
+	 * @return pair of iterator to the entry of the property and flag, true if the property was inserted.
+	 */
+	std::pair<iterator, bool> insert_or_assign(style_property p, style_value v);
+
+	size_t erase(style_property p);
+
+	iterator erase(const_iterator i);
+
+	bool operator==(const style_map& m) const
+	{
+		return this->presence == m.presence && this->entries == m.entries;
+	}
+
+	bool operator!=(const style_map& m) const
+	{
+		return !this->operator==(m);
+	}
+};
+
 /**
  * @brief An element which has 'style' attribute or can be styled.
  */
 struct styleable : public cssom::styleable {
-	std::map<style_property, style_value> styles;
-	std::map<style_property, style_value> presentation_attributes;
+	style_map styles;
+	style_map presentation_attributes;
 
 	std::vector<std::string> classes;
 
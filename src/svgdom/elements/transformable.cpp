@@ -29,6 +29,8 @@ SOFTWARE.
 
 #include <utki/debug.hpp>
 
+#include "../number_scanner.hxx"
+#include "../perfect_hash.hxx"
 #include "../util.hxx"
 
 using namespace svgdom;
@@ -86,120 +88,111 @@ std::string transformable::transformations_to_string() const
 	return s.str();
 }
 
+namespace {
+constexpr auto transformation_names = make_perfect_hash_map<transformable::transformation::type>({
+	{   "matrix",    transformable::transformation::type::matrix},
+	{"translate", transformable::transformation::type::translate},
+	{    "scale",     transformable::transformation::type::scale},
+	{   "rotate",    transformable::transformation::type::rotate},
+	{    "skewX",     transformable::transformation::type::skewx},
+	{    "skewY",     transformable::transformation::type::skewy}
+});
+} // namespace
+
 decltype(transformable::transformations) transformable::parse(std::string_view str)
 {
 	decltype(transformable::transformations) ret;
 
-	try {
-		utki::string_parser p(str);
+	number_scanner p(str);
+
+	// reads number followed by optional separator
+	auto read = [&p](real& v) {
+		auto n = p.read_number();
+		if (!n) {
+			return false;
+		}
+		v = *n;
+		p.skip_whitespaces_and_comma();
+		return true;
+	};
+
+	p.skip_whitespaces();
+
+	while (!p.empty()) {
+		auto transform = p.read_word_until('(');
+
+		//		TRACE(<< "transform = " << transform << std::endl)
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+		transformation t;
+
+		if (auto type = transformation_names.find(transform)) {
+			t.type_v = *type;
+		} else {
+			return ret; // unknown transformation, stop parsing
+		}
+
 		p.skip_whitespaces();
 
-		while (!p.empty()) {
-			auto transform = p.read_word_until('(');
-
-			//		TRACE(<< "transform = " << transform << std::endl)
-
-			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
-			transformation t;
-
-			if (transform == "matrix") {
-				t.type_v = transformation::type::matrix;
-			} else if (transform == "translate") {
-				t.type_v = transformation::type::translate;
-			} else if (transform == "scale") {
-				t.type_v = transformation::type::scale;
-			} else if (transform == "rotate") {
-				t.type_v = transformation::type::rotate;
-			} else if (transform == "skewX") {
-				t.type_v = transformation::type::skewx;
-			} else if (transform == "skewY") {
-				t.type_v = transformation::type::skewy;
-			} else {
-				return ret; // unknown transformation, stop parsing
-			}
-
-			p.skip_whitespaces();
-
-			if (p.read_char() != '(') {
-				//			TRACE(<< "error: expected '('" << std::endl)
-				// TODO: throw invalid argument
-				return ret; // expected (
-			}
-
-			p.skip_whitespaces();
-
-			switch (t.type_v) {
-				default:
-					ASSERT(false)
-					break;
-				case transformation::type::matrix:
-					t.a = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					t.b = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					t.c = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					t.d = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					t.e = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					t.f = p.read_number<real>();
-					break;
-				case transformation::type::translate:
-					t.x() = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					try {
-						t.y() = p.read_number<real>();
-					} catch (std::invalid_argument&) {
-						t.y() = 0;
-					}
-					break;
-				case transformation::type::scale:
-					t.x() = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					try {
-						t.y() = p.read_number<real>();
-					} catch (std::invalid_argument&) {
-						t.y() = t.x();
-					}
-					break;
-				case transformation::type::rotate:
-					t.angle() = p.read_number<real>();
-					p.skip_whitespaces_and_comma();
-					try {
-						t.x() = p.read_number<real>();
-					} catch (std::invalid_argument&) {
-						t.x() = 0;
-						t.y() = 0;
-						break;
-					}
-
-					p.skip_whitespaces_and_comma();
-					t.y() = p.read_number<real>();
-					break;
-				case transformation::type::skewy:
-				case transformation::type::skewx:
-					t.angle() = p.read_number<real>();
-					break;
-			}
+		if (p.read_char() != '(') {
+			//			TRACE(<< "error: expected '('" << std::endl)
+			return ret; // expected (
+		}
 
-			p.skip_whitespaces();
+		p.skip_whitespaces();
 
-			if (p.read_char() != ')') {
-				return ret; // expected )
-			}
+		bool ok = true;
 
-			ret.push_back(t);
+		switch (t.type_v) {
+			default:
+				ASSERT(false)
+				break;
+			case transformation::type::matrix:
+				ok = read(t.a) && read(t.b) && read(t.c) && read(t.d) && read(t.e) && read(t.f);
+				break;
+			case transformation::type::translate:
+				ok = read(t.x());
+				if (!read(t.y())) {
+					t.y() = 0;
+				}
+				break;
+			case transformation::type::scale:
+				ok = read(t.x());
+				if (!read(t.y())) {
+					t.y() = t.x();
+				}
+				break;
+			case transformation::type::rotate:
+				ok = read(t.angle());
+				if (!read(t.x())) {
+					t.x() = 0;
+					t.y() = 0;
+					break;
+				}
+				ok = ok && read(t.y());
+				break;
+			case transformation::type::skewy:
+			case transformation::type::skewx:
+				ok = read(t.angle());
+				break;
+		}
 
-			p.skip_whitespaces_and_comma();
+		if (!ok) {
+			utki::log_debug([&](auto& o) {
+				o << "WARNING: transformable::parse(): malformed transformation, ignored: " << p.get_view() << std::endl;
+			});
+			return ret;
 		}
-		// NOLINTNEXTLINE(bugprone-empty-catch)
-	} catch (std::invalid_argument& e) {
-		utki::log_debug([&](auto& o) {
-			o << "WARNING: transformable::parse(): std::invalid_argument exception caught, ignored." << '\n'
-			  << "  e.what() = " << e.what() << std::endl;
-		});
-		// ignore the exception
+
+		p.skip_whitespaces();
+
+		if (p.read_char() != ')') {
+			return ret; // expected )
+		}
+
+		ret.push_back(t);
+
+		p.skip_whitespaces_and_comma();
 	}
 
 	return ret;
@@ -29,6 +29,7 @@ SOFTWARE.
 
 #include <utki/debug.hpp>
 
+#include "../number_scanner.hxx"
 #include "../util.hxx"
 
 using namespace svgdom;
@@ -37,17 +38,17 @@ decltype(view_boxed::view_box) view_boxed::parse_view_box(std::string_view str)
 {
 	decltype(view_boxed::view_box) ret;
 
-	try {
-		utki::string_parser p(str);
+	number_scanner p(str);
 
-		for (auto& r : ret) {
-			p.skip_whitespaces_and_comma();
-			r = p.read_number<real>();
+	for (auto& r : ret) {
+		p.skip_whitespaces_and_comma();
+		auto n = p.read_number();
+		if (!n) {
+			return {
+				{-1, -1, -1, -1}
+			};
 		}
-	} catch (std::invalid_argument&) {
-		return {
-			{-1, -1, -1, -1}
-		};
+		r = *n;
 	}
 
 	return ret;
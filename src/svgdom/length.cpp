@@ -30,6 +30,7 @@ SOFTWARE.
 #include <cmath>
 #include <string_view>
 
+#include "number_scanner.hxx"
 #include "util.hxx"
 
 using namespace svgdom;
@@ -39,9 +40,13 @@ length length::parse(std::string_view str)
 	// NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
 	length ret;
 
-	utki::string_parser p(str);
+	number_scanner p(str);
 
-	ret.value = p.read_number<real>();
+	auto value = p.read_number();
+	if (!value) {
+		return {0, length_unit::unknown};
+	}
+	ret.value = value.value();
 
 	auto unit = p.read_word();
 
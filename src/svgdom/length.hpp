@@ -58,6 +58,12 @@ struct length {
 	real value;
 	length_unit unit;
 
+	/**
+	 * @brief Parse length from string.
+	 * @param str - string to parse, e.g. '10px'.
+	 * @return parsed length.
+	 * @return length of 0 with unknown unit, in case the string does not start with a number.
+	 */
 	static length parse(std::string_view str);
 
 	length() = default;
@@ -79,6 +85,11 @@ struct length {
 
 	real to_px(real dpi) const noexcept;
 
+	bool operator==(const length& l) const
+	{
+		return !this->operator!=(l);
+	}
+
 	bool operator!=(const length& l) const
 	{
 		return this->value != l.value || (this->unit != l.unit && this->value != real(0));
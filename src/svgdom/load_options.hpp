@@ -0,0 +1,156 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+namespace svgdom {
+
+/**
+ * @brief Kinds of SVG elements known to svgdom.
+ */
+enum class element_kind {
+	svg,
+	symbol,
+	g,
+	defs,
+	use,
+	path,
+	rect,
+	circle,
+	ellipse,
+	line,
+	polyline,
+	polygon,
+	linear_gradient,
+	radial_gradient,
+	gradient_stop,
+	filter,
+	fe_gaussian_blur,
+	fe_color_matrix,
+	fe_blend,
+	fe_composite,
+	image,
+	mask,
+	text,
+	style,
+
+	enum_size
+};
+
+/**
+ * @brief Selective SVG document loading options.
+ * Elements which are not selected for loading are skipped together with their subtrees.
+ * Skipping is done on top of the XML tokenizer, not within it: the whole subtree is still
+ * tokenized, and the attributes of the skipped element itself are decoded to find its id.
+ * Inside of the skipped subtree no attributes are decoded and no elements are created.
+ * The root element of the document is never skipped.
+ *
+ * The loading functions which take the options by reference use them only during the call,
+ * but the options must not be modified during that call, since the loader refers to the strings
+ * of the 'ids' list instead of copying them. svgdom::loader and svgdom::pipelined_loader
+ * store a copy of the options, so the options passed to their constructors can be destroyed right away.
+ */
+struct load_options {
+	/**
+	 * @brief Kinds of elements to load.
+	 * Indexed by element_kind. By default, all kinds of elements are loaded.
+	 */
+	std::bitset<size_t(element_kind::enum_size)> element_kinds = std::bitset<size_t(element_kind::enum_size)>().set();
+
+	/**
+	 * @brief Allowed element ids.
+	 * If not empty, then elements having an id which is not in this list are skipped.
+	 * Elements without id are not affected.
+	 */
+	std::vector<std::string> ids;
+
+	/**
+	 * @brief Number of threads to decode heavy attributes with.
+	 * If not 1, then the document structure is parsed first, with the heavy attributes
+	 * (path data, points, transformations, 'style' attributes and, if decode_data_urls is set,
+	 * 'data:' URLs of images) deferred,
+	 * and after that the deferred attributes are decoded in parallel by the given number of threads.
+	 * The loaded document is fully decoded.
+	 * The decoding is done by a thread pool shared by all loads of the process,
+	 * so the number of threads is limited by the number of hardware threads, and in case
+	 * several documents are loaded in parallel at the same time, their decoding is done one after another.
+	 * 0 means number of hardware threads.
+	 */
+	unsigned num_threads = 1;
+
+	/**
+	 * @brief Whether to decode images embedded into 'data:' URLs.
+	 * If true, then the 'data:' URL of an image element is decoded to image_element::data,
+	 * and the IRI of the element is cleared.
+	 * If false, the 'data:' URLs are left in the IRIs as is.
+	 */
+	bool decode_data_urls = false;
+
+	/**
+	 * @brief Whether to find position of the error in malformed input.
+	 * Only used by the try_load() functions. If true, then in case of malformed input the line and column
+	 * of the error are reported in the load result. The position is found by parsing the input once again,
+	 * this time byte by byte, so malformed input takes considerably longer to load than well formed one.
+	 * If false, malformed input is parsed only once and the error is reported without position.
+	 */
+	bool locate_errors = false;
+
+	/**
+	 * @brief Exclude kind of elements from loading.
+	 * @param kind - kind of elements to skip.
+	 * @return reference to this options object.
+	 */
+	load_options& skip(element_kind kind)
+	{
+		this->element_kinds.reset(size_t(kind));
+		return *this;
+	}
+};
+
+/**
+ * @brief SVG document loading statistics.
+ * Byte counts include element names, attribute names and values and element contents,
+ * but do not include XML markup characters.
+ */
+struct load_stats {
+	/**
+	 * @brief Number of bytes parsed into the document.
+	 */
+	size_t parsed_bytes = 0;
+
+	/**
+	 * @brief Number of bytes skipped due to load options.
+	 */
+	size_t skipped_bytes = 0;
+};
+
+} // namespace svgdom
@@ -0,0 +1,317 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "config.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief Scanner of SVG numbers and separators.
+ * Allocation-free and exception-free tokenizer used by geometry attribute parsers
+ * (path data, points, transformations, view box etc.).
+ * Numbers are parsed independently of the current C locale.
+ */
+class number_scanner
+{
+	const char* cur;
+	const char* end;
+
+	enum char_class : uint8_t {
+		none = 0,
+		space = 1,
+		comma = 2,
+		digit = 4
+	};
+
+	constexpr static std::array<uint8_t, 0x100> char_classes = []() {
+		std::array<uint8_t, 0x100> ret{};
+		for (char c = '0'; c <= '9'; ++c) {
+			ret[uint8_t(c)] = char_class::digit;
+		}
+		ret[uint8_t(' ')] = char_class::space;
+		ret[uint8_t('\t')] = char_class::space;
+		ret[uint8_t('\n')] = char_class::space;
+		ret[uint8_t('\r')] = char_class::space;
+		ret[uint8_t(',')] = char_class::comma;
+		return ret;
+	}();
+
+	static bool is(char c, char_class cc) noexcept
+	{
+		return (char_classes[uint8_t(c)] & cc) != 0;
+	}
+
+	static uint64_t load_eight_chars(const char* p) noexcept
+	{
+		// compilers turn this into a single load on little-endian architectures
+		uint64_t ret = 0;
+		for (unsigned i = 0; i != sizeof(ret); ++i) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			ret |= uint64_t(uint8_t(p[i])) << (i * 8);
+		}
+		return ret;
+	}
+
+	// SWAR check if all 8 characters packed into the 64-bit value are decimal digits
+	static bool is_eight_digits(uint64_t chars) noexcept
+	{
+		return ((chars & 0xf0f0f0f0f0f0f0f0) | (((chars + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) ==
+			0x3333333333333333;
+	}
+
+	// SWAR conversion of 8 decimal digits packed into the 64-bit value
+	static uint32_t parse_eight_digits(uint64_t chars) noexcept
+	{
+		constexpr uint64_t mask = 0x000000ff000000ff;
+		constexpr uint64_t mul1 = 0x000f424000000064; // 100 + (1000000 << 32)
+		constexpr uint64_t mul2 = 0x0000271000000001; // 1 + (10000 << 32)
+		constexpr auto base = 10;
+		constexpr auto byte_bits = 8;
+		constexpr auto half_bits = 32;
+
+		chars -= 0x3030303030303030;
+		chars = (chars * base) + (chars >> byte_bits);
+		chars = (((chars & mask) * mul1) + (((chars >> (byte_bits * 2)) & mask) * mul2)) >> half_bits;
+		return uint32_t(chars);
+	}
+
+	// returns number of digits read
+	size_t read_digits(const char*& p, uint64_t& mantissa) const noexcept
+	{
+		constexpr uint32_t eight_digits_multiplier = 100000000;
+		constexpr auto base = 10;
+
+		auto start = p;
+		while (this->end - p >= 8) {
+			auto chars = load_eight_chars(p);
+			if (!is_eight_digits(chars)) {
+				break;
+			}
+			mantissa = mantissa * eight_digits_multiplier + parse_eight_digits(chars);
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			p += 8;
+		}
+		for (; p != this->end && is(*p, char_class::digit); ++p) {
+			mantissa = mantissa * base + uint64_t(*p - '0');
+		}
+		return size_t(p - start);
+	}
+
+	static double parse_slow(std::string_view str);
+
+public:
+	number_scanner(std::string_view str) noexcept :
+		cur(str.data()),
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		end(str.data() + str.size())
+	{}
+
+	bool empty() const noexcept
+	{
+		return this->cur == this->end;
+	}
+
+	/**
+	 * @brief Get rest of the string which is not scanned yet.
+	 * @return string view of the rest of the string.
+	 */
+	std::string_view get_view() const noexcept
+	{
+		return {this->cur, size_t(this->end - this->cur)};
+	}
+
+	/**
+	 * @brief Peek next character.
+	 * @return next character.
+	 * @return 0 if the scanner is empty.
+	 */
+	char peek_char() const noexcept
+	{
+		if (this->empty()) {
+			return 0;
+		}
+		return *this->cur;
+	}
+
+	/**
+	 * @brief Read next character.
+	 * @return next character.
+	 * @return 0 if the scanner is empty.
+	 */
+	char read_char() noexcept
+	{
+		if (this->empty()) {
+			return 0;
+		}
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		return *this->cur++;
+	}
+
+	void skip_whitespaces() noexcept
+	{
+		for (; this->cur != this->end && is(*this->cur, char_class::space); ++this->cur) {
+		}
+	}
+
+	/**
+	 * @brief Skip whitespaces and at most one comma.
+	 */
+	void skip_whitespaces_and_comma() noexcept
+	{
+		this->skip_whitespaces();
+		if (this->cur != this->end && *this->cur == ',') {
+			++this->cur;
+			this->skip_whitespaces();
+		}
+	}
+
+	/**
+	 * @brief Read word.
+	 * Skips leading whitespaces and reads characters until next whitespace.
+	 * @return the read word.
+	 */
+	std::string_view read_word() noexcept
+	{
+		return this->read_word_until('\0');
+	}
+
+	/**
+	 * @brief Read word until given character.
+	 * Skips leading whitespaces and reads characters until next whitespace or the given character.
+	 * @param c - character to stop at.
+	 * @return the read word.
+	 */
+	std::string_view read_word_until(char c) noexcept
+	{
+		this->skip_whitespaces();
+		auto start = this->cur;
+		for (; this->cur != this->end && *this->cur != c && !is(*this->cur, char_class::space); ++this->cur) {
+		}
+		return {start, size_t(this->cur - start)};
+	}
+
+	/**
+	 * @brief Read number.
+	 * Skips leading whitespaces and reads a number in SVG number format,
+	 * i.e. optional sign, digits with optional decimal point and optional exponent.
+	 * @return the read number.
+	 * @return std::nullopt if there is no number at the current position,
+	 *         only leading whitespaces are skipped in this case.
+	 */
+	std::optional<real> read_number()
+	{
+		this->skip_whitespaces();
+
+		auto p = this->cur;
+
+		bool negative = false;
+		if (p != this->end && (*p == '-' || *p == '+')) {
+			negative = *p == '-';
+			++p;
+		}
+
+		auto number_start = p;
+
+		uint64_t mantissa = 0;
+		auto num_digits = this->read_digits(p, mantissa);
+
+		int exponent = 0;
+
+		if (p != this->end && *p == '.') {
+			++p;
+			auto num_fraction_digits = this->read_digits(p, mantissa);
+			num_digits += num_fraction_digits;
+			exponent = -int(num_fraction_digits);
+		}
+
+		if (num_digits == 0) {
+			return {};
+		}
+
+		if (p != this->end && (*p == 'e' || *p == 'E')) {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+			auto e = p + 1;
+			bool negative_exponent = false;
+			if (e != this->end && (*e == '-' || *e == '+')) {
+				negative_exponent = *e == '-';
+				++e;
+			}
+			// otherwise 'e' is not a part of the number, e.g. it can be 'em' length unit
+			if (e != this->end && is(*e, char_class::digit)) {
+				constexpr int max_exponent = 10000;
+				constexpr auto base = 10;
+
+				int exp = 0;
+				for (; e != this->end && is(*e, char_class::digit); ++e) {
+					if (exp < max_exponent) {
+						exp = exp * base + (*e - '0');
+					}
+				}
+				exponent += negative_exponent ? -exp : exp;
+				p = e;
+			}
+		}
+
+		// Clinger's fast path: mantissa and power of 10 are exactly representable as double,
+		// so the result of single multiplication or division is correctly rounded
+		constexpr size_t max_exact_digits = 19;
+		constexpr uint64_t max_exact_mantissa = uint64_t(1) << 53;
+		constexpr std::array<double, 23> powers_of_10 = {
+			1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		constexpr auto max_exact_exponent = int(powers_of_10.size() - 1);
+
+		double value = 0;
+		if (num_digits <= max_exact_digits && mantissa <= max_exact_mantissa && exponent >= -max_exact_exponent &&
+			exponent <= max_exact_exponent)
+		{
+			value = double(mantissa);
+			if (exponent < 0) {
+				value /= powers_of_10[size_t(-exponent)];
+			} else {
+				value *= powers_of_10[size_t(exponent)];
+			}
+		} else {
+			value = parse_slow({number_start, size_t(p - number_start)});
+		}
+
+		this->cur = p;
+
+		return real(negative ? -value : value);
+	}
+};
+
+} // namespace svgdom
@@ -38,6 +38,9 @@ SOFTWARE.
 #include "util/casters.hpp"
 
 #include "malformed_svg_error.hpp"
+#include "number_scanner.hxx"
+#include "perfect_hash.hxx"
+#include "thread_pool.hxx"
 #include "util.hxx"
 
 using namespace svgdom;
@@ -61,206 +64,390 @@ gradient::spread_method gradient_string_to_spread_method(std::string_view str)
 }
 } // namespace
 
+namespace {
+constexpr auto attribute_names = make_perfect_hash_map<attribute_name>({
+	{"id", attribute_name::id},
+	{"class", attribute_name::class_attribute},
+	{"style", attribute_name::style},
+	{"href", attribute_name::href},
+	{"x", attribute_name::x},
+	{"y", attribute_name::y},
+	{"width", attribute_name::width},
+	{"height", attribute_name::height},
+	{"cx", attribute_name::cx},
+	{"cy", attribute_name::cy},
+	{"r", attribute_name::r},
+	{"rx", attribute_name::rx},
+	{"ry", attribute_name::ry},
+	{"fx", attribute_name::fx},
+	{"fy", attribute_name::fy},
+	{"x1", attribute_name::x1},
+	{"y1", attribute_name::y1},
+	{"x2", attribute_name::x2},
+	{"y2", attribute_name::y2},
+	{"d", attribute_name::d},
+	{"points", attribute_name::points},
+	{"offset", attribute_name::offset},
+	{"transform", attribute_name::transform},
+	{"gradientTransform", attribute_name::gradient_transform},
+	{"gradientUnits", attribute_name::gradient_units},
+	{"spreadMethod", attribute_name::spread_method},
+	{"viewBox", attribute_name::view_box},
+	{"preserveAspectRatio", attribute_name::preserve_aspect_ratio},
+	{"maskUnits", attribute_name::mask_units},
+	{"maskContentUnits", attribute_name::mask_content_units},
+	{"filterUnits", attribute_name::filter_units},
+	{"primitiveUnits", attribute_name::primitive_units},
+	{"result", attribute_name::result},
+	{"in", attribute_name::in},
+	{"in2", attribute_name::in2},
+	{"stdDeviation", attribute_name::std_deviation},
+	{"type", attribute_name::type},
+	{"values", attribute_name::values},
+	{"mode", attribute_name::mode},
+	{"operator", attribute_name::operator_attribute},
+	{"k1", attribute_name::k1},
+	{"k2", attribute_name::k2},
+	{"k3", attribute_name::k3},
+	{"k4", attribute_name::k4},
+});
+} // namespace
+
 void parser::push_namespaces()
 {
-	// parse default namespace
-	{
-		auto i = this->attributes.find("xmlns");
-		if (i != this->attributes.end()) {
-			if (i->second == svg_namespace) {
-				this->default_namespace_stack.push_back(xml_namespace::svg);
-			} else if (i->second == xlink_namespace) {
-				this->default_namespace_stack.push_back(xml_namespace::xlink);
-			} else {
-				this->default_namespace_stack.push_back(xml_namespace::unknown);
-			}
-		} else {
-			if (this->default_namespace_stack.size() == 0) {
-				this->default_namespace_stack.push_back(xml_namespace::unknown);
-			} else {
-				this->default_namespace_stack.push_back(this->default_namespace_stack.back());
-			}
-		}
-	}
-
-	// parse other namespaces
-	{
-		std::string xmlns = "xmlns:";
-
-		this->namespace_stack.emplace_back();
+	++this->namespace_depth;
 
-		for (auto& e : this->attributes) {
-			const auto& attr = e.first;
+	for (const auto& a : this->get_attributes()) {
+		std::string_view attr = a.name;
 
-			if (attr.substr(0, xmlns.length()) != xmlns) {
-				continue;
-			}
+		constexpr std::string_view xmlns = "xmlns";
 
-			ASSERT(attr.length() >= xmlns.length())
-			auto ns_name = attr.substr(xmlns.length(), attr.length() - xmlns.length());
+		if (attr.substr(0, xmlns.length()) != xmlns) {
+			continue;
+		}
 
-			if (e.second == svg_namespace) {
-				this->namespace_stack.back()[ns_name] = xml_namespace::svg;
-			} else if (e.second == xlink_namespace) {
-				this->namespace_stack.back()[ns_name] = xml_namespace::xlink;
-			}
+		auto ns = xml_namespace::unknown;
+		if (a.value == svg_namespace) {
+			ns = xml_namespace::svg;
+		} else if (a.value == xlink_namespace) {
+			ns = xml_namespace::xlink;
 		}
 
-		this->flipped_namespace_stack.push_back(utki::flip_map(this->namespace_stack.back()));
+		if (attr.length() == xmlns.length()) {
+			// default namespace
+			this->default_namespace_stack.emplace_back(this->namespace_depth, this->default_namespace);
+			this->default_namespace = ns;
+		} else if (attr[xmlns.length()] == ':') {
+			auto prefix = attr.substr(xmlns.length() + 1);
+			this->namespace_declarations.push_back({this->namespace_depth, ns, std::string(prefix)});
+		}
 	}
 }
 
 void parser::pop_namespaces()
 {
-	ASSERT(this->namespace_stack.size() != 0)
-	this->namespace_stack.pop_back();
-	ASSERT(this->default_namespace_stack.size() != 0)
-	this->default_namespace_stack.pop_back();
-	ASSERT(this->flipped_namespace_stack.size() != 0)
-	this->flipped_namespace_stack.pop_back();
+	ASSERT(this->namespace_depth != 0)
+
+	while (!this->namespace_declarations.empty() &&
+		   this->namespace_declarations.back().depth == this->namespace_depth)
+	{
+		this->namespace_declarations.pop_back();
+	}
+
+	if (!this->default_namespace_stack.empty() && this->default_namespace_stack.back().first == this->namespace_depth) {
+		this->default_namespace = this->default_namespace_stack.back().second;
+		this->default_namespace_stack.pop_back();
+	}
+
+	--this->namespace_depth;
 }
 
-void parser::parse_element()
+void parser::decode_attributes()
 {
-	auto nsn = this->get_namespace(this->cur_element);
-	// TRACE(<< "nsn.name = " << nsn.name << std::endl)
-	switch (nsn.ns) {
-		case xml_namespace::svg:
-			if (nsn.name == svg_element::tag) {
-				this->parse_svg_element();
-			} else if (nsn.name == symbol_element::tag) {
-				this->parse_symbol_element();
-			} else if (nsn.name == g_element::tag) {
-				this->parse_g_element();
-			} else if (nsn.name == defs_element::tag) {
-				this->parse_defs_element();
-			} else if (nsn.name == use_element::tag) {
-				this->parse_use_element();
-			} else if (nsn.name == path_element::tag) {
-				this->parse_path_element();
-			} else if (nsn.name == linear_gradient_element::tag) {
-				this->parse_linear_gradient_element();
-			} else if (nsn.name == radial_gradient_element::tag) {
-				this->parse_radial_gradient_element();
-			} else if (nsn.name == gradient::stop_element::tag) {
-				this->parse_gradient_stop_element();
-			} else if (nsn.name == rect_element::tag) {
-				this->parse_rect_element();
-			} else if (nsn.name == circle_element::tag) {
-				this->parse_circle_element();
-			} else if (nsn.name == ellipse_element::tag) {
-				this->parse_ellipse_element();
-			} else if (nsn.name == line_element::tag) {
-				this->parse_line_element();
-			} else if (nsn.name == polyline_element::tag) {
-				this->parse_polyline_element();
-			} else if (nsn.name == polygon_element::tag) {
-				this->parse_polygon_element();
-			} else if (nsn.name == filter_element::tag) {
-				this->parse_filter_element();
-			} else if (nsn.name == fe_gaussian_blur_element::tag) {
-				this->parse_fe_gaussian_blur_element();
-			} else if (nsn.name == fe_color_matrix_element::tag) {
-				this->parse_fe_color_matrix_element();
-			} else if (nsn.name == fe_blend_element::tag) {
-				this->parse_fe_blend_element();
-			} else if (nsn.name == fe_composite_element::tag) {
-				this->parse_fe_composite_element();
-			} else if (nsn.name == image_element::tag) {
-				this->parse_image_element();
-			} else if (nsn.name == mask_element::tag) {
-				this->parse_mask_element();
-			} else if (nsn.name == text_element::tag) {
-				this->parse_text_element();
-			} else if (nsn.name == style_element::tag) {
-				this->parse_style_element();
-			} else {
-				// unknown element, ignore
-				break;
+	for (auto& a : this->get_attributes()) {
+		a.attr = attribute_name::unknown;
+		a.property = style_property::unknown;
+
+		auto nsn = this->get_namespace(a.name);
+		a.ns = nsn.ns;
+		a.prefixed = nsn.name.size() != a.name.size();
+
+		if (a.ns == xml_namespace::unknown) {
+			continue;
+		}
+
+		if (auto n = attribute_names.find(nsn.name)) {
+			a.attr = *n;
+
+			// unprefixed attribute takes precedence over the prefixed one
+			auto& slot = this->attribute_table[size_t(a.ns)][size_t(a.attr)];
+			if (!slot || (slot->prefixed && !a.prefixed)) {
+				slot = &a;
 			}
-			return;
-		default:
-			// unknown namespace, ignore
-			break;
+		} else if (a.ns == xml_namespace::svg) {
+			a.property = styleable::string_to_property(nsn.name);
+		}
 	}
-	this->element_stack.push_back(nullptr);
 }
 
-parser::xml_namespace parser::find_namespace(const std::string& ns)
+void parser::clear_attributes()
 {
-	for (auto i = this->namespace_stack.rbegin(), e = this->namespace_stack.rend(); i != e; ++i) {
-		auto iter = i->find(std::string(ns));
-		if (iter == i->end()) {
-			continue;
+	for (const auto& a : this->get_attributes()) {
+		if (a.attr != attribute_name::unknown) {
+			this->attribute_table[size_t(a.ns)][size_t(a.attr)] = nullptr;
 		}
-		ASSERT(ns == iter->first)
-		return iter->second;
 	}
-	return xml_namespace::unknown;
+	this->num_attributes = 0;
 }
 
-std::optional<std::string_view> parser::find_flipped_namespace(xml_namespace ns)
+namespace {
+constexpr auto element_kinds_map = make_perfect_hash_map<element_kind>({
+	{svg_element::tag, element_kind::svg},
+	{symbol_element::tag, element_kind::symbol},
+	{g_element::tag, element_kind::g},
+	{defs_element::tag, element_kind::defs},
+	{use_element::tag, element_kind::use},
+	{path_element::tag, element_kind::path},
+	{rect_element::tag, element_kind::rect},
+	{circle_element::tag, element_kind::circle},
+	{ellipse_element::tag, element_kind::ellipse},
+	{line_element::tag, element_kind::line},
+	{polyline_element::tag, element_kind::polyline},
+	{polygon_element::tag, element_kind::polygon},
+	{linear_gradient_element::tag, element_kind::linear_gradient},
+	{radial_gradient_element::tag, element_kind::radial_gradient},
+	{gradient::stop_element::tag, element_kind::gradient_stop},
+	{filter_element::tag, element_kind::filter},
+	{fe_gaussian_blur_element::tag, element_kind::fe_gaussian_blur},
+	{fe_color_matrix_element::tag, element_kind::fe_color_matrix},
+	{fe_blend_element::tag, element_kind::fe_blend},
+	{fe_composite_element::tag, element_kind::fe_composite},
+	{image_element::tag, element_kind::image},
+	{mask_element::tag, element_kind::mask},
+	{text_element::tag, element_kind::text},
+	{style_element::tag, element_kind::style},
+});
+} // namespace
+
+void parser::reset()
 {
-	for (auto i = this->flipped_namespace_stack.rbegin(), e = this->flipped_namespace_stack.rend(); i != e; ++i) {
-		auto iter = i->find(ns);
-		if (iter == i->end()) {
-			continue;
-		}
-		ASSERT(ns == iter->first)
-		return {iter->second};
+	this->xml.emplace(*this);
+
+	this->namespace_depth = 0;
+	this->namespace_declarations.clear();
+	this->default_namespace = xml_namespace::unknown;
+	this->default_namespace_stack.clear();
+
+	this->clear_attributes();
+	this->cur_element.clear();
+
+	this->svg.reset();
+	this->root_found = false;
+	this->element_stack.clear();
+	this->open_elements.clear();
+
+	this->skip_depth = 0;
+	this->stats = load_stats();
+
+	this->deferred_attributes.clear();
+	this->element_deferred_attributes_begin = 0;
+
+	this->error.clear();
+}
+
+void parser::set_options(const load_options& options)
+{
+	this->element_kinds = options.element_kinds;
+	this->decode_data_urls = options.decode_data_urls;
+
+	// Parallel decoding is done after the structural pass, till then the heavy attributes are deferred.
+	// In streaming mode the elements are destroyed right after they are parsed, so nothing to decode in parallel.
+	if (!this->streaming_visitor) {
+		this->num_threads = options.num_threads;
+	}
+
+	this->allowed_ids.clear();
+	for (const auto& id : options.ids) {
+		this->allowed_ids.insert(id);
 	}
-	return {};
 }
 
-parser::namespace_name_pair parser::get_namespace(const std::string& xml_name)
+bool parser::is_skipped(element_kind kind)
 {
-	namespace_name_pair ret;
+	// root element is never skipped
+	if (this->element_stack.empty()) {
+		return false;
+	}
 
-	auto colon_index = xml_name.find_first_of(':');
-	if (colon_index == std::string::npos) {
-		ret.ns = this->default_namespace_stack.back();
-		ret.name = xml_name;
-		return ret;
+	if (!this->element_kinds.test(size_t(kind))) {
+		return true;
 	}
 
-	ASSERT(xml_name.length() >= colon_index + 1)
+	if (!this->allowed_ids.empty()) {
+		if (auto id = this->find_attribute(xml_namespace::svg, attribute_name::id)) {
+			return this->allowed_ids.find(*id) == this->allowed_ids.end();
+		}
+	}
+
+	return false;
+}
+
+void parser::skip_element()
+{
+	// the element's name and attributes were counted as parsed, recount them as skipped
+	size_t num_bytes = this->cur_element.size();
+	for (const auto& a : this->get_attributes()) {
+		num_bytes += a.name.size() + a.value.size();
+	}
+	ASSERT(this->stats.parsed_bytes >= num_bytes)
+	this->stats.parsed_bytes -= num_bytes;
+	this->stats.skipped_bytes += num_bytes;
 
-	ret.ns = this->find_namespace(xml_name.substr(0, colon_index));
-	ret.name = xml_name.substr(colon_index + 1, xml_name.length() - 1 - colon_index);
+	// the element is not entered, so leave its namespace scope right away
+	this->pop_namespaces();
 
-	return ret;
+	this->skip_depth = 1;
 }
 
-const std::string* parser::find_attribute(const std::string& name)
+void parser::parse_element()
 {
-	auto i = this->attributes.find(name);
-	if (i != this->attributes.end()) {
-		return &i->second;
+	auto nsn = this->get_namespace(this->cur_element);
+	// TRACE(<< "nsn.name = " << nsn.name << std::endl)
+	if (nsn.ns == xml_namespace::svg) {
+		if (auto kind = element_kinds_map.find(nsn.name)) {
+			if (this->is_skipped(*kind)) {
+				this->skip_element();
+				return;
+			}
+
+			switch (*kind) {
+				case element_kind::svg:
+					this->parse_svg_element();
+					break;
+				case element_kind::symbol:
+					this->parse_symbol_element();
+					break;
+				case element_kind::g:
+					this->parse_g_element();
+					break;
+				case element_kind::defs:
+					this->parse_defs_element();
+					break;
+				case element_kind::use:
+					this->parse_use_element();
+					break;
+				case element_kind::path:
+					this->parse_path_element();
+					break;
+				case element_kind::rect:
+					this->parse_rect_element();
+					break;
+				case element_kind::circle:
+					this->parse_circle_element();
+					break;
+				case element_kind::ellipse:
+					this->parse_ellipse_element();
+					break;
+				case element_kind::line:
+					this->parse_line_element();
+					break;
+				case element_kind::polyline:
+					this->parse_polyline_element();
+					break;
+				case element_kind::polygon:
+					this->parse_polygon_element();
+					break;
+				case element_kind::linear_gradient:
+					this->parse_linear_gradient_element();
+					break;
+				case element_kind::radial_gradient:
+					this->parse_radial_gradient_element();
+					break;
+				case element_kind::gradient_stop:
+					this->parse_gradient_stop_element();
+					break;
+				case element_kind::filter:
+					this->parse_filter_element();
+					break;
+				case element_kind::fe_gaussian_blur:
+					this->parse_fe_gaussian_blur_element();
+					break;
+				case element_kind::fe_color_matrix:
+					this->parse_fe_color_matrix_element();
+					break;
+				case element_kind::fe_blend:
+					this->parse_fe_blend_element();
+					break;
+				case element_kind::fe_composite:
+					this->parse_fe_composite_element();
+					break;
+				case element_kind::image:
+					this->parse_image_element();
+					break;
+				case element_kind::mask:
+					this->parse_mask_element();
+					break;
+				case element_kind::text:
+					this->parse_text_element();
+					break;
+				case element_kind::style:
+					this->parse_style_element();
+					break;
+				case element_kind::enum_size:
+					ASSERT(false)
+					break;
+			}
+			return;
+		}
+		// unknown element, ignore
 	}
-	return nullptr;
+	// unknown namespace, ignore
+	this->element_stack.push_back(nullptr);
 }
 
-const std::string* parser::find_attribute_of_namespace(xml_namespace ns, const std::string& name)
+parser::xml_namespace parser::find_namespace(std::string_view ns)
 {
-	if (this->default_namespace_stack.back() == ns) {
-		if (auto a = this->find_attribute(name)) {
-			return a;
+	// there are very few namespace declarations in scope, normally it is one or two declared in the root element
+	for (auto i = this->namespace_declarations.rbegin(), e = this->namespace_declarations.rend(); i != e; ++i) {
+		if (i->prefix == ns) {
+			return i->ns;
 		}
 	}
+	return xml_namespace::unknown;
+}
 
-	if (auto prefix = this->find_flipped_namespace(ns)) {
-		auto attr = std::string(prefix.value()) + ":" + name;
-		if (auto a = this->find_attribute(attr)) {
-			return a;
+parser::namespace_name_pair parser::get_namespace(std::string_view xml_name)
+{
+	auto colon_index = xml_name.find_first_of(':');
+	if (colon_index == std::string_view::npos) {
+		// xmlns attribute declares namespace, it is not in any namespace itself
+		if (xml_name == "xmlns") {
+			return {xml_namespace::unknown, xml_name};
 		}
+		return {this->default_namespace, xml_name};
+	}
+
+	ASSERT(xml_name.length() >= colon_index + 1)
+
+	return {
+		this->find_namespace(xml_name.substr(0, colon_index)), //
+		xml_name.substr(colon_index + 1)
+	};
+}
+
+std::string* parser::find_attribute(xml_namespace ns, attribute_name name)
+{
+	auto a = this->attribute_table[size_t(ns)][size_t(name)];
+	if (a) {
+		return &a->value;
 	}
 	return nullptr;
 }
 
 void parser::fill_element(element& e)
 {
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "id")) {
-		e.id = *a;
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::id)) {
+		e.id = std::move(*a);
 	}
 }
 
@@ -270,13 +457,17 @@ void parser::fill_gradient(gradient& g)
 	this->fill_referencing(g);
 	this->fill_styleable(g);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "spreadMethod")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::spread_method)) {
 		g.spread_method_attribute = gradient_string_to_spread_method(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "gradientTransform")) {
-		g.transformations = transformable::parse(*a);
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::gradient_transform)) {
+		if (this->is_deferring()) {
+			this->defer(std::move(*a), &g.transformations);
+		} else {
+			g.transformations = transformable::parse(*a);
+		}
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "gradientUnits")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::gradient_units)) {
 		g.units = parse_coordinate_units(*a);
 	}
 }
@@ -285,35 +476,35 @@ void parser::fill_rectangle(rectangle& r, const rectangle& default_values)
 {
 	r = default_values;
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::x)) {
 		r.x = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::y)) {
 		r.y = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "width")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::width)) {
 		r.width = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "height")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::height)) {
 		r.height = length::parse(*a);
 	}
 }
 
 void parser::fill_referencing(referencing& e)
 {
-	auto a = this->find_attribute_of_namespace(
+	auto a = this->find_attribute(
 		xml_namespace::xlink, //
-		"href"
+		attribute_name::href
 	);
 	if (!a) {
 		// In some SVG documents the svg namespace is used instead of xlink, though this is against SVG spec we allow to do so.
-		a = this->find_attribute_of_namespace(
+		a = this->find_attribute(
 			xml_namespace::svg, //
-			"href"
+			attribute_name::href
 		);
 	}
 	if (a) {
-		e.iri = *a;
+		e.iri = std::move(*a);
 	}
 }
 
@@ -328,43 +519,42 @@ void parser::fill_styleable(styleable& s)
 {
 	ASSERT(s.styles.size() == 0)
 
-	for (auto& a : this->attributes) {
-		auto nsn = this->get_namespace(a.first);
-		switch (nsn.ns) {
-			case xml_namespace::svg:
-				if (nsn.name == "style") {
-					s.styles = styleable::parse(a.second);
-					break;
-				} else if (nsn.name == "class") {
-					s.classes = utki::split(a.second);
-					break;
-				}
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::style)) {
+		if (this->is_deferring()) {
+			this->defer(std::move(*a), &s.styles);
+		} else {
+			s.styles = styleable::parse(*a);
+		}
+	}
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::class_attribute)) {
+		s.classes = utki::split(*a);
+	}
 
-				// parse style attributes
-				{
-					style_property type = styleable::string_to_property(nsn.name);
-					if (type != style_property::unknown) {
-						s.presentation_attributes[type] = styleable::parse_style_property_value(type, a.second);
-					}
-				}
-				break;
-			default:
-				break;
+	// parse presentation attributes
+	for (const auto& a : this->get_attributes()) {
+		if (a.property == style_property::unknown) {
+			continue;
 		}
+		ASSERT(a.ns == xml_namespace::svg)
+		s.presentation_attributes[a.property] = styleable::parse_style_property_value(a.property, a.value);
 	}
 }
 
 void parser::fill_transformable(transformable& t)
 {
 	ASSERT(t.transformations.size() == 0)
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "transform")) {
-		t.transformations = transformable::parse(*a);
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::transform)) {
+		if (this->is_deferring()) {
+			this->defer(std::move(*a), &t.transformations);
+		} else {
+			t.transformations = transformable::parse(*a);
+		}
 	}
 }
 
 void parser::fill_view_boxed(view_boxed& v)
 {
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "viewBox")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::view_box)) {
 		v.view_box = svg_element::parse_view_box(*a);
 	}
 }
@@ -381,11 +571,64 @@ void parser::fill_style(style_element& e)
 
 void parser::fill_aspect_ratioed(aspect_ratioed& e)
 {
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "preserveAspectRatio")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::preserve_aspect_ratio)) {
 		e.preserve_aspect_ratio.parse(*a);
 	}
 }
 
+namespace {
+// The decoded image replaces the 'data:' URL, so that the image is not kept twice.
+void decode_data_url(image_element& e)
+{
+	e.data = image_element::parse_data_url(e.iri);
+	if (e.data.has_value()) {
+		e.iri.clear();
+		e.iri.shrink_to_fit();
+	}
+}
+} // namespace
+
+void parser::defer(std::string value, decltype(deferred_attribute::target) target)
+{
+	ASSERT(this->is_deferring())
+	this->deferred_attributes.push_back({std::move(value), target});
+}
+
+void parser::decode_deferred()
+{
+	if (this->deferred_attributes.empty()) {
+		return;
+	}
+
+	thread_pool::get_shared().run(
+		this->deferred_attributes.size(),
+		[this](size_t i, size_t) {
+			const auto& a = this->deferred_attributes[i];
+			std::visit(
+				[&a](auto target) {
+					using target_type = std::remove_pointer_t<decltype(target)>;
+					if constexpr (std::is_same_v<target_type, decltype(transformable::transformations)>) {
+						*target = transformable::parse(a.value);
+					} else if constexpr (std::is_same_v<target_type, decltype(styleable::styles)>) {
+						*target = styleable::parse(a.value);
+					} else if constexpr (std::is_same_v<target_type, decltype(path_element::path)>) {
+						*target = path_element::parse(a.value);
+					} else if constexpr (std::is_same_v<target_type, decltype(polyline_shape::points)>) {
+						*target = polyline_shape::parse(a.value);
+					} else {
+						static_assert(std::is_same_v<target_type, image_element>, "unexpected deferred attribute type");
+						decode_data_url(*target);
+					}
+				},
+				a.target
+			);
+		},
+		this->num_threads
+	);
+
+	this->deferred_attributes.clear();
+}
+
 void parser::add_element(std::unique_ptr<element> e)
 {
 	ASSERT(e)
@@ -393,19 +636,29 @@ void parser::add_element(std::unique_ptr<element> e)
 	auto elem = e.get();
 
 	if (this->element_stack.empty()) {
-		if (this->svg) {
-			throw malformed_svg_error("more than one root element found in the SVG document");
+		if (this->root_found) {
+			this->error = "more than one root element found in the SVG document";
+			this->deferred_attributes.resize(this->element_deferred_attributes_begin);
+			return;
 		}
 
 		element_caster<svg_element> c;
 		e->accept(c);
 		if (!c.pointer) {
-			throw malformed_svg_error("first element of the SVG document is not an 'svg' element");
+			this->error = "first element of the SVG document is not an 'svg' element";
+			this->deferred_attributes.resize(this->element_deferred_attributes_begin);
+			return;
 		}
 
-		[[maybe_unused]] auto ptr = e.release();
-		// NOLINTNEXTLINE(bugprone-unused-return-value, "false positive")
-		this->svg = std::unique_ptr<svg_element>(c.pointer);
+		this->root_found = true;
+
+		if (this->streaming_visitor) {
+			this->open_elements.push_back(std::move(e));
+		} else {
+			[[maybe_unused]] auto ptr = e.release();
+			// NOLINTNEXTLINE(bugprone-unused-return-value, "false positive")
+			this->svg = std::unique_ptr<svg_element>(c.pointer);
+		}
 	} else {
 		container_caster c;
 		auto parent = this->element_stack.back();
@@ -413,8 +666,14 @@ void parser::add_element(std::unique_ptr<element> e)
 			parent->accept(c);
 		}
 		if (c.pointer) {
-			c.pointer->children.push_back(std::move(e));
+			if (this->streaming_visitor) {
+				this->open_elements.push_back(std::move(e));
+			} else {
+				c.pointer->children.push_back(std::move(e));
+			}
 		} else {
+			// the element is dropped, so forget its deferred attributes
+			this->deferred_attributes.resize(this->element_deferred_attributes_begin);
 			elem = nullptr;
 		}
 	}
@@ -430,13 +689,13 @@ void parser::parse_circle_element()
 
 	this->fill_shape(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cx")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::cx)) {
 		ret->cx = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cy")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::cy)) {
 		ret->cy = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "r")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::r)) {
 		ret->r = length::parse(*a);
 	}
 
@@ -468,11 +727,11 @@ void parser::parse_mask_element()
 	this->fill_rectangle(*ret);
 	this->fill_styleable(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "maskUnits")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::mask_units)) {
 		ret->mask_units = parse_coordinate_units(*a);
 	}
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "maskContentUnits")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::mask_content_units)) {
 		ret->mask_content_units = parse_coordinate_units(*a);
 	}
 
@@ -520,16 +779,16 @@ void parser::parse_ellipse_element()
 
 	this->fill_shape(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cx")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::cx)) {
 		ret->cx = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cy")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::cy)) {
 		ret->cy = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "rx")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::rx)) {
 		ret->rx = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "ry")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::ry)) {
 		ret->ry = length::parse(*a);
 	}
 
@@ -559,11 +818,13 @@ void parser::parse_gradient_stop_element()
 
 	this->fill_styleable(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "offset")) {
-		utki::string_parser p(*a);
-		ret->offset = p.read_number<real>();
-		if (!p.empty() && p.read_char() == '%') {
-			ret->offset /= std::centi::den;
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::offset)) {
+		number_scanner p(*a);
+		if (auto offset = p.read_number()) {
+			ret->offset = offset.value();
+			if (p.read_char() == '%') {
+				ret->offset /= std::centi::den;
+			}
 		}
 	}
 
@@ -579,16 +840,16 @@ void parser::parse_line_element()
 
 	this->fill_shape(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x1")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::x1)) {
 		ret->x1 = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y1")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::y1)) {
 		ret->y1 = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x2")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::x2)) {
 		ret->x2 = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y2")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::y2)) {
 		ret->y2 = length::parse(*a);
 	}
 
@@ -615,10 +876,10 @@ void parser::parse_filter_element()
 	);
 	this->fill_referencing(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "filterUnits")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::filter_units)) {
 		ret->filter_units = svgdom::parse_coordinate_units(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "primitiveUnits")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::primitive_units)) {
 		ret->primitive_units = svgdom::parse_coordinate_units(*a);
 	}
 
@@ -631,22 +892,22 @@ void parser::fill_filter_primitive(filter_primitive& p)
 	this->fill_rectangle(p);
 	this->fill_styleable(p);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "result")) {
-		p.result = *a;
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::result)) {
+		p.result = std::move(*a);
 	}
 }
 
 void parser::fill_inputable(inputable& p)
 {
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "in")) {
-		p.in = *a;
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::in)) {
+		p.in = std::move(*a);
 	}
 }
 
 void parser::fill_second_inputable(second_inputable& p)
 {
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "in2")) {
-		p.in2 = *a;
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::in2)) {
+		p.in2 = std::move(*a);
 	}
 }
 
@@ -660,7 +921,7 @@ void parser::parse_fe_gaussian_blur_element()
 	this->fill_filter_primitive(*ret);
 	this->fill_inputable(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "stdDeviation")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::std_deviation)) {
 		ret->std_deviation = parse_number_and_optional_number(*a, {-1, -1});
 	}
 
@@ -677,7 +938,7 @@ void parser::parse_fe_color_matrix_element()
 	this->fill_filter_primitive(*ret);
 	this->fill_inputable(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "type")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::type)) {
 		if (*a == "saturate") {
 			ret->type_ = fe_color_matrix_element::type::saturate;
 		} else if (*a == "hueRotate") {
@@ -689,7 +950,7 @@ void parser::parse_fe_color_matrix_element()
 		}
 	}
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "values")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::values)) {
 		switch (ret->type_) {
 			default:
 				ASSERT(false) // should never get here, MATRIX should always be the default value
@@ -697,9 +958,13 @@ void parser::parse_fe_color_matrix_element()
 			case fe_color_matrix_element::type::matrix:
 				// 20 values expected
 				{
-					utki::string_parser p(*a);
+					number_scanner p(*a);
 					for (auto& v : ret->values) {
-						v = p.read_number<real>();
+						auto n = p.read_number();
+						if (!n) {
+							break;
+						}
+						v = n.value();
 						p.skip_whitespaces_and_comma();
 					}
 				}
@@ -708,7 +973,9 @@ void parser::parse_fe_color_matrix_element()
 				// fall-through
 			case fe_color_matrix_element::type::saturate:
 				// one value is expected
-				ret->values[0] = utki::string_parser(*a).read_number<real>();
+				if (auto n = number_scanner(*a).read_number()) {
+					ret->values[0] = n.value();
+				}
 				break;
 			case fe_color_matrix_element::type::luminance_to_alpha:
 				// no values are expected
@@ -730,7 +997,7 @@ void parser::parse_fe_blend_element()
 	this->fill_inputable(*ret);
 	this->fill_second_inputable(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "mode")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::mode)) {
 		if (*a == "normal") {
 			ret->mode_ = fe_blend_element::mode::normal;
 		} else if (*a == "multiply") {
@@ -758,7 +1025,7 @@ void parser::parse_fe_composite_element()
 	this->fill_inputable(*ret);
 	this->fill_second_inputable(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "operator")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::operator_attribute)) {
 		if (*a == "over") {
 			ret->operator_attribute = fe_composite_element::operator_type::over;
 		} else if (*a == "in") {
@@ -774,20 +1041,20 @@ void parser::parse_fe_composite_element()
 		}
 	}
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k1")) {
-		ret->k1 = real(std::strtod(a->c_str(), nullptr));
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::k1)) {
+		ret->k1 = number_scanner(*a).read_number().value_or(0);
 	}
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k2")) {
-		ret->k2 = real(std::strtod(a->c_str(), nullptr));
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::k2)) {
+		ret->k2 = number_scanner(*a).read_number().value_or(0);
 	}
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k3")) {
-		ret->k3 = real(std::strtod(a->c_str(), nullptr));
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::k3)) {
+		ret->k3 = number_scanner(*a).read_number().value_or(0);
 	}
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "k4")) {
-		ret->k4 = real(std::strtod(a->c_str(), nullptr));
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::k4)) {
+		ret->k4 = number_scanner(*a).read_number().value_or(0);
 	}
 
 	this->add_element(std::move(ret));
@@ -802,16 +1069,16 @@ void parser::parse_linear_gradient_element()
 
 	this->fill_gradient(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x1")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::x1)) {
 		ret->x1 = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y1")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::y1)) {
 		ret->y1 = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "x2")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::x2)) {
 		ret->x2 = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "y2")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::y2)) {
 		ret->y2 = length::parse(*a);
 	}
 
@@ -827,8 +1094,12 @@ void parser::parse_path_element()
 
 	this->fill_shape(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "d")) {
-		ret->path = path_element::parse(*a);
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::d)) {
+		if (this->is_deferring()) {
+			this->defer(std::move(*a), &ret->path);
+		} else {
+			ret->path = path_element::parse(*a);
+		}
 	}
 
 	this->add_element(std::move(ret));
@@ -843,8 +1114,12 @@ void parser::parse_polygon_element()
 
 	this->fill_shape(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "points")) {
-		ret->points = ret->parse(*a);
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::points)) {
+		if (this->is_deferring()) {
+			this->defer(std::move(*a), &ret->points);
+		} else {
+			ret->points = ret->parse(*a);
+		}
 	}
 
 	this->add_element(std::move(ret));
@@ -859,8 +1134,12 @@ void parser::parse_polyline_element()
 
 	this->fill_shape(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "points")) {
-		ret->points = ret->parse(*a);
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::points)) {
+		if (this->is_deferring()) {
+			this->defer(std::move(*a), &ret->points);
+		} else {
+			ret->points = ret->parse(*a);
+		}
 	}
 
 	this->add_element(std::move(ret));
@@ -875,19 +1154,19 @@ void parser::parse_radial_gradient_element()
 
 	this->fill_gradient(*ret);
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cx")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::cx)) {
 		ret->cx = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "cy")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::cy)) {
 		ret->cy = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "r")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::r)) {
 		ret->r = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "fx")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::fx)) {
 		ret->fx = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "fy")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::fy)) {
 		ret->fy = length::parse(*a);
 	}
 
@@ -904,10 +1183,10 @@ void parser::parse_rect_element()
 	this->fill_shape(*ret);
 	this->fill_rectangle(*ret, rect_element::rectangle_default_values());
 
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "rx")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::rx)) {
 		ret->rx = length::parse(*a);
 	}
-	if (auto a = this->find_attribute_of_namespace(xml_namespace::svg, "ry")) {
+	if (auto a = this->find_attribute(xml_namespace::svg, attribute_name::ry)) {
 		ret->ry = length::parse(*a);
 	}
 
@@ -944,6 +1223,18 @@ void parser::parse_image_element()
 	this->fill_referencing(*ret);
 	this->fill_aspect_ratioed(*ret);
 
+	// embedded images are big, so they are decoded in parallel as well
+	constexpr std::string_view data_url_scheme = "data:";
+	if (this->decode_data_urls &&
+		std::string_view(ret->iri).substr(0, data_url_scheme.size()) == data_url_scheme)
+	{
+		if (this->is_deferring()) {
+			this->defer({}, ret.get());
+		} else {
+			decode_data_url(*ret);
+		}
+	}
+
 	this->add_element(std::move(ret));
 }
 
@@ -982,30 +1273,83 @@ void parser::parse_use_element()
 
 void parser::on_element_start(utki::span<const char> name)
 {
-	this->cur_element = utki::make_string(name);
+	if (!this->error.empty()) {
+		return;
+	}
+	if (this->skip_depth != 0) {
+		++this->skip_depth;
+		this->stats.skipped_bytes += name.size();
+		return;
+	}
+	this->stats.parsed_bytes += name.size();
+	this->cur_element.assign(name.data(), name.size());
 }
 
 void parser::on_element_end(utki::span<const char> name)
 {
+	if (!this->error.empty()) {
+		return;
+	}
+	if (this->skip_depth != 0) {
+		--this->skip_depth;
+		return;
+	}
 	this->pop_namespaces();
+
+	ASSERT(!this->element_stack.empty())
+	auto elem = this->element_stack.back();
 	this->element_stack.pop_back();
+
+	if (this->streaming_visitor && elem) {
+		ASSERT(!this->open_elements.empty())
+		ASSERT(this->open_elements.back().get() == elem)
+
+		// the element is destroyed after the visit
+		auto e = std::move(this->open_elements.back());
+		this->open_elements.pop_back();
+
+		e->accept(*this->streaming_visitor);
+	}
 }
 
 void parser::on_attribute_parsed(utki::span<const char> name, utki::span<const char> value)
 {
+	if (!this->error.empty()) {
+		return;
+	}
+	if (this->skip_depth != 0) {
+		this->stats.skipped_bytes += name.size() + value.size();
+		return;
+	}
+	this->stats.parsed_bytes += name.size() + value.size();
+
 	ASSERT(this->cur_element.length() != 0)
-	this->attributes[utki::make_string(name)] = utki::make_string(value);
+
+	if (this->num_attributes == this->attributes.size()) {
+		this->attributes.emplace_back();
+	}
+	auto& a = this->attributes[this->num_attributes];
+	++this->num_attributes;
+
+	a.name.assign(name.data(), name.size());
+	a.value.assign(value.data(), value.size());
 }
 
 void parser::on_attributes_end(bool is_empty_element)
 {
+	if (!this->error.empty() || this->skip_depth != 0) {
+		return;
+	}
 	//	TRACE(<< "this->cur_element = " << this->cur_element << std::endl)
 	//	TRACE(<< "this->element_stack.size() = " << this->element_stack.size() << std::endl)
 	this->push_namespaces();
+	this->decode_attributes();
+
+	this->element_deferred_attributes_begin = this->deferred_attributes.size();
 
 	this->parse_element();
 
-	this->attributes.clear();
+	this->clear_attributes();
 	this->cur_element.clear();
 }
 
@@ -1047,6 +1391,15 @@ public:
 
 void parser::on_content_parsed(utki::span<const char> str)
 {
+	if (!this->error.empty()) {
+		return;
+	}
+	if (this->skip_depth != 0) {
+		this->stats.skipped_bytes += str.size();
+		return;
+	}
+	this->stats.parsed_bytes += str.size();
+
 	if (this->element_stack.empty() || !this->element_stack.back()) {
 		return;
 	}
@@ -1055,10 +1408,34 @@ void parser::on_content_parsed(utki::span<const char> str)
 	this->element_stack.back()->accept(v);
 }
 
-std::unique_ptr<svg_element> parser::get_dom()
+namespace {
+constexpr std::string_view unclosed_tags_error = "malformed SVG content: unclosed XML tags";
+} // namespace
+
+std::string_view parser::get_error() const noexcept
 {
-	if (!this->element_stack.empty()) {
-		throw std::invalid_argument("malformed SVG content: unclosed XML tags");
+	if (!this->error.empty()) {
+		return this->error;
 	}
+	if (!this->element_stack.empty() || this->skip_depth != 0) {
+		return unclosed_tags_error;
+	}
+	return {};
+}
+
+void parser::throw_if_error() const
+{
+	if (!this->error.empty()) {
+		throw malformed_svg_error(this->error);
+	}
+	if (!this->element_stack.empty() || this->skip_depth != 0) {
+		throw std::invalid_argument(std::string(unclosed_tags_error));
+	}
+}
+
+std::unique_ptr<svg_element> parser::get_dom()
+{
+	this->throw_if_error();
+	this->decode_deferred();
 	return std::move(this->svg);
 }
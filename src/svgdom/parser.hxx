@@ -27,9 +27,13 @@ SOFTWARE.
 
 #pragma once
 
-#include <map>
+#include <array>
+#include <bitset>
 #include <memory>
 #include <optional>
+#include <string_view>
+#include <unordered_set>
+#include <variant>
 #include <vector>
 
 #include <mikroxml/mikroxml.hpp>
@@ -47,54 +51,256 @@ SOFTWARE.
 #include "elements/transformable.hpp"
 #include "elements/view_boxed.hpp"
 
+#include "load_options.hpp"
+
 namespace svgdom {
 
-class parser : public mikroxml::parser
+/**
+ * @brief Local names of attributes known to the parser.
+ */
+enum class attribute_name {
+	unknown,
+	id,
+	class_attribute,
+	style,
+	href,
+	x,
+	y,
+	width,
+	height,
+	cx,
+	cy,
+	r,
+	rx,
+	ry,
+	fx,
+	fy,
+	x1,
+	y1,
+	x2,
+	y2,
+	d,
+	points,
+	offset,
+	transform,
+	gradient_transform,
+	gradient_units,
+	spread_method,
+	view_box,
+	preserve_aspect_ratio,
+	mask_units,
+	mask_content_units,
+	filter_units,
+	primitive_units,
+	result,
+	in,
+	in2,
+	std_deviation,
+	type,
+	values,
+	mode,
+	operator_attribute,
+	k1,
+	k2,
+	k3,
+	k4,
+
+	enum_size
+};
+
+class parser
 {
+	// feeds the tokens to the parser from another thread
+	friend class pipelined_loader;
+
+	// XML tokenizer which passes the tokens to the parser
+	class tokenizer : public mikroxml::parser
+	{
+		svgdom::parser& owner;
+
+	public:
+		tokenizer(svgdom::parser& owner) :
+			owner(owner)
+		{}
+
+		void on_element_start(utki::span<const char> name) override
+		{
+			this->owner.on_element_start(name);
+		}
+
+		void on_element_end(utki::span<const char> name) override
+		{
+			this->owner.on_element_end(name);
+		}
+
+		void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+		{
+			this->owner.on_attribute_parsed(name, value);
+		}
+
+		void on_attributes_end(bool is_empty_element) override
+		{
+			this->owner.on_attributes_end(is_empty_element);
+		}
+
+		void on_content_parsed(utki::span<const char> str) override
+		{
+			this->owner.on_content_parsed(str);
+		}
+	};
+
+	// The tokenizer is recreated for each document, since mikroxml::parser cannot be reset.
+	std::optional<tokenizer> xml;
+
 	enum class xml_namespace {
 		unknown,
 		svg,
-		xlink
+		xlink,
+
+		enum_size
 	};
 
-	std::vector<std::map<std::string, xml_namespace>> namespace_stack;
+	// Namespace declarations are rare, usually all of them are in the root element.
+	// So, only elements which declare namespaces add scope records, for other elements
+	// entering and leaving the namespace scope costs just incrementing/decrementing the depth counter.
+	size_t namespace_depth = 0;
 
-	std::vector<std::map<xml_namespace, std::string>> flipped_namespace_stack;
+	struct namespace_declaration {
+		size_t depth;
+		xml_namespace ns;
+		std::string prefix; // empty for default namespace
+	};
+
+	std::vector<namespace_declaration> namespace_declarations;
 
-	std::vector<xml_namespace> default_namespace_stack;
+	// current default namespace
+	xml_namespace default_namespace = xml_namespace::unknown;
 
-	xml_namespace find_namespace(const std::string& ns);
-	std::optional<std::string_view> find_flipped_namespace(xml_namespace ns);
+	// depth and previous default namespace for each default namespace declaration in scope
+	std::vector<std::pair<size_t, xml_namespace>> default_namespace_stack;
+
+	xml_namespace find_namespace(std::string_view ns);
 
-	// TODO: why lint complains here on macos?
-	// NOLINTNEXTLINE(bugprone-exception-escape, "error: an exception may be thrown in function")
 	struct namespace_name_pair {
 		xml_namespace ns = xml_namespace::unknown;
+		std::string_view name;
+	};
+
+	namespace_name_pair get_namespace(std::string_view xml_name);
+
+	struct decoded_attribute {
 		std::string name;
+		std::string value;
+
+		xml_namespace ns = xml_namespace::unknown;
+
+		// true if the attribute name has namespace prefix
+		bool prefixed = false;
+
+		attribute_name attr = attribute_name::unknown;
+
+		// presentation attribute, in case the attribute is not one of the known attribute names
+		style_property property = style_property::unknown;
 	};
 
-	namespace_name_pair get_namespace(const std::string& xml_name);
+	// Attributes of the current element. The vector is reused from element to element,
+	// only first num_attributes entries are valid. This way the strings keep their
+	// allocated memory and most attributes are decoded without any memory allocations.
+	std::vector<decoded_attribute> attributes;
+	size_t num_attributes = 0;
 
-	const std::string* find_attribute(const std::string& name);
+	utki::span<decoded_attribute> get_attributes() noexcept
+	{
+		return {this->attributes.data(), this->num_attributes};
+	}
 
-	const std::string* find_attribute_of_namespace(xml_namespace ns, const std::string& name);
+	// Known attributes of the current element, indexed by namespace and attribute name.
+	std::array<
+		std::array<decoded_attribute*, size_t(attribute_name::enum_size)>,
+		size_t(xml_namespace::enum_size)>
+		attribute_table{};
+
+	void decode_attributes();
+	void clear_attributes();
+
+	// Attribute values are returned as non-const, so that the string attributes which are stored
+	// in elements as is (id, href, result, in and in2) can be moved to the element instead of copying
+	// them once again. The values themselves are still copied once from the mikroxml token buffer,
+	// they are not borrowed from the input buffer.
+	std::string* find_attribute(xml_namespace ns, attribute_name name);
 
 	void push_namespaces();
 	void pop_namespaces();
 
 	std::string cur_element;
-	std::map<std::string, std::string> attributes;
 
 	std::unique_ptr<svg_element> svg; // root svg element
+	bool root_found = false;
 	std::vector<element*> element_stack;
 
+	// In streaming mode the parsed elements are not added to the document tree,
+	// instead, they are owned by the parser until closed and then passed to the visitor.
+	visitor* streaming_visitor = nullptr;
+	std::vector<std::unique_ptr<element>> open_elements;
+
+	std::bitset<size_t(element_kind::enum_size)> element_kinds = std::bitset<size_t(element_kind::enum_size)>().set();
+
+	// views of the load_options::ids strings
+	std::unordered_set<std::string_view> allowed_ids;
+
+	// Depth inside of the currently skipped subtree, 0 if not skipping.
+	// Inside of a skipped subtree only this counter is maintained, nothing else is done.
+	size_t skip_depth = 0;
+
+	load_stats stats;
+
+	bool decode_data_urls = false;
+
+	// Number of threads to decode the heavy attributes with after the structural pass.
+	// If not 1, then the heavy attributes are deferred during the structural pass.
+	unsigned num_threads = 1;
+
+	// Heavy attribute value to be decoded after the structural pass, along with the element member to decode it to.
+	// Each value is decoded to a different member, so the values can be decoded in parallel without synchronization.
+	// Image 'data:' URLs are decoded from the element's IRI, so the value is empty for those.
+	struct deferred_attribute {
+		std::string value;
+		std::variant<
+			decltype(transformable::transformations)*,
+			decltype(styleable::styles)*,
+			decltype(path_element::path)*,
+			decltype(polyline_shape::points)*,
+			image_element*>
+			target;
+	};
+
+	std::vector<deferred_attribute> deferred_attributes;
+
+	// index of the first deferred attribute of the current element
+	size_t element_deferred_attributes_begin = 0;
+
+	bool is_deferring() const noexcept
+	{
+		return this->num_threads != 1;
+	}
+
+	void defer(std::string value, decltype(deferred_attribute::target) target);
+	void decode_deferred();
+
+	bool is_skipped(element_kind kind);
+	void skip_element();
+
+	// Description of the first error found in the SVG document, empty if there were no errors.
+	// Once an error is found, the rest of the document is ignored.
+	std::string error;
+
 	void add_element(std::unique_ptr<element> e);
 
-	void on_element_start(utki::span<const char> name) override;
-	void on_element_end(utki::span<const char> name) override;
-	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override;
-	void on_attributes_end(bool is_empty_element) override;
-	void on_content_parsed(utki::span<const char> str) override;
+	void on_element_start(utki::span<const char> name);
+	void on_element_end(utki::span<const char> name);
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value);
+	void on_attributes_end(bool is_empty_element);
+	void on_content_parsed(utki::span<const char> str);
 
 	void fill_element(element& e);
 	void fill_referencing(referencing& e);
@@ -147,7 +353,115 @@ class parser : public mikroxml::parser
 	void parse_element();
 
 public:
+	parser()
+	{
+		this->xml.emplace(*this);
+	}
+
+	/**
+	 * @brief Create parser in streaming mode.
+	 * @param streaming_visitor - visitor to pass each parsed element to when it is closed.
+	 */
+	explicit parser(visitor& streaming_visitor) :
+		streaming_visitor(&streaming_visitor)
+	{
+		this->xml.emplace(*this);
+	}
+
+	// the tokenizer refers to the parser
+	parser(const parser&) = delete;
+	parser& operator=(const parser&) = delete;
+
+	parser(parser&&) = delete;
+	parser& operator=(parser&&) = delete;
+
+	~parser() = default;
+
+	/**
+	 * @brief Feed next chunk of XML document.
+	 * @param data - chunk of the document.
+	 * @throw mikroxml::malformed_xml - in case of malformed XML.
+	 */
+	void feed(utki::span<const char> data)
+	{
+		this->xml->feed(data);
+	}
+
+	/**
+	 * @brief Feed next chunk of XML document.
+	 * @param data - chunk of the document.
+	 * @throw mikroxml::malformed_xml - in case of malformed XML.
+	 */
+	void feed(utki::span<const uint8_t> data)
+	{
+		this->xml->feed(data);
+	}
+
+	/**
+	 * @brief Finish parsing of XML document.
+	 * @throw mikroxml::malformed_xml - in case of malformed XML.
+	 */
+	void end()
+	{
+		this->xml->end();
+	}
+
+	/**
+	 * @brief Prepare the parser for parsing next document.
+	 * Loading options are kept. Internal buffers keep their allocated memory,
+	 * so parsing of the next document does less memory allocations.
+	 */
+	void reset();
+
+	/**
+	 * @brief Set selective loading options.
+	 * Should be called before parsing is started.
+	 * @param options - selective loading options, must outlive the parser.
+	 */
+	void set_options(const load_options& options);
+
+	/**
+	 * @brief Get loading statistics.
+	 * @return numbers of bytes parsed and skipped so far.
+	 */
+	const load_stats& get_stats() const noexcept
+	{
+		return this->stats;
+	}
+
+	/**
+	 * @brief Get SVG document error.
+	 * Should be called after parsing is finished, i.e. after end() is called.
+	 * @return description of the error found in the SVG document.
+	 * @return empty string if the document is well-formed.
+	 */
+	std::string_view get_error() const noexcept;
+
+	/**
+	 * @brief Check if structural error was found in the SVG document.
+	 * Can be called during parsing. Once an error is found, the rest of the document is ignored.
+	 * @return true if error was found.
+	 */
+	bool has_error() const noexcept
+	{
+		return !this->error.empty();
+	}
+
+	/**
+	 * @brief Get parsed SVG document.
+	 * Should be called after parsing is finished, i.e. after end() is called.
+	 * @return parsed SVG document.
+	 * @throw malformed_svg_error - in case the document has structural errors.
+	 * @throw std::invalid_argument - in case the document has unclosed XML tags.
+	 */
 	std::unique_ptr<svg_element> get_dom();
+
+	/**
+	 * @brief Throw exception in case the document has errors.
+	 * @throw malformed_svg_error - in case the document has structural errors.
+	 * @throw std::invalid_argument - in case the document has unclosed XML tags.
+	 */
+	void throw_if_error() const;
 };
 
 } // namespace svgdom
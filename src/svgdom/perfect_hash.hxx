@@ -0,0 +1,253 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace svgdom {
+
+/**
+ * @brief Perfect hash map from strings, generated at compile time.
+ * The map is built with the "hash and displace" scheme: keys are first distributed
+ * into buckets, then for each bucket a displacement value is searched which places
+ * all the bucket's keys into free slots of the table. So, a lookup costs one hash
+ * of the key, two table reads and one string comparison.
+ * @tparam value_type - type of the mapped values.
+ * @tparam num_entries - number of entries in the map.
+ */
+template <typename value_type, size_t num_entries>
+class perfect_hash_map
+{
+public:
+	struct entry {
+		std::string_view key;
+		value_type value{};
+	};
+
+private:
+	constexpr static size_t num_buckets = num_entries / 2 + 1;
+
+	constexpr static size_t num_slots = []() {
+		// keep load factor below 0.5 so that displacements are found quickly
+		size_t ret = 1;
+		while (ret < num_entries * 2) {
+			ret <<= 1;
+		}
+		return ret;
+	}();
+
+	constexpr static uint32_t slot_mask = uint32_t(num_slots - 1);
+
+	std::array<entry, num_entries> entries{};
+
+	std::array<uint32_t, num_buckets> displacements{};
+
+	// entry index + 1, 0 for empty slot
+	std::array<uint16_t, num_slots> slots{};
+
+	static_assert(num_entries < std::numeric_limits<uint16_t>::max(), "too many entries");
+
+	constexpr static uint32_t hash(std::string_view str) noexcept
+	{
+		// FNV-1a
+		constexpr uint32_t offset_basis = 2166136261;
+		constexpr uint32_t prime = 16777619;
+
+		uint32_t h = offset_basis;
+		for (char c : str) {
+			h ^= uint8_t(c);
+			h *= prime;
+		}
+		return h;
+	}
+
+	constexpr static uint32_t mix(uint32_t h, uint32_t seed) noexcept
+	{
+		// murmur3 finalizer
+		constexpr uint32_t golden_ratio = 0x9e3779b9;
+		constexpr uint32_t c1 = 0x85ebca6b;
+		constexpr uint32_t c2 = 0xc2b2ae35;
+		constexpr auto shift_16 = 16;
+		constexpr auto shift_13 = 13;
+
+		h ^= seed * golden_ratio;
+		h ^= h >> shift_16;
+		h *= c1;
+		h ^= h >> shift_13;
+		h *= c2;
+		h ^= h >> shift_16;
+		return h;
+	}
+
+	constexpr static size_t bucket_of(uint32_t h) noexcept
+	{
+		return mix(h, 0) % num_buckets;
+	}
+
+	constexpr static size_t slot_of(uint32_t h, uint32_t displacement) noexcept
+	{
+		return mix(h, displacement) & slot_mask;
+	}
+
+public:
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
+	constexpr perfect_hash_map(const std::pair<std::string_view, value_type> (&init)[num_entries])
+	{
+		std::array<uint32_t, num_entries> hashes{};
+		std::array<size_t, num_buckets + 1> bucket_begins{};
+
+		for (size_t i = 0; i != num_entries; ++i) {
+			this->entries[i].key = init[i].first;
+			this->entries[i].value = init[i].second;
+
+			hashes[i] = hash(init[i].first);
+			++bucket_begins[bucket_of(hashes[i]) + 1];
+		}
+
+		// sort entry indices by buckets
+		size_t max_bucket_size = 0;
+		for (size_t b = 0; b != num_buckets; ++b) {
+			auto size = bucket_begins[b + 1];
+			if (size > max_bucket_size) {
+				max_bucket_size = size;
+			}
+			bucket_begins[b + 1] += bucket_begins[b];
+		}
+
+		std::array<size_t, num_entries> bucketed{};
+		{
+			auto fill_pos = bucket_begins;
+			for (size_t i = 0; i != num_entries; ++i) {
+				bucketed[fill_pos[bucket_of(hashes[i])]++] = i;
+			}
+		}
+
+		// place bigger buckets first, they are harder to place
+		for (size_t size = max_bucket_size; size != 0; --size) {
+			for (size_t b = 0; b != num_buckets; ++b) {
+				auto begin = bucket_begins[b];
+				auto end = bucket_begins[b + 1];
+
+				if (end - begin != size) {
+					continue;
+				}
+
+				constexpr uint32_t max_displacement = 0x10000;
+
+				for (uint32_t d = 1;; ++d) {
+					if (d == max_displacement) {
+						// duplicate keys will end up here
+						throw std::logic_error("perfect_hash_map: could not place keys, duplicate keys?");
+					}
+
+					auto placed_end = begin;
+					for (; placed_end != end; ++placed_end) {
+						auto i = bucketed[placed_end];
+						auto& s = this->slots[slot_of(hashes[i], d)];
+						if (s != 0) {
+							break;
+						}
+						s = uint16_t(i + 1);
+					}
+
+					if (placed_end == end) {
+						this->displacements[b] = d;
+						break;
+					}
+
+					// undo partial placement
+					for (auto j = begin; j != placed_end; ++j) {
+						this->slots[slot_of(hashes[bucketed[j]], d)] = 0;
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Find value by key.
+	 * @param key - key to look for.
+	 * @return pointer to the value mapped to the key.
+	 * @return nullptr if there is no such key in the map.
+	 */
+	constexpr const value_type* find(std::string_view key) const noexcept
+	{
+		auto h = hash(key);
+		auto s = this->slots[slot_of(h, this->displacements[bucket_of(h)])];
+		if (s == 0) {
+			return nullptr;
+		}
+		const auto& e = this->entries[s - 1];
+		if (e.key != key) {
+			return nullptr;
+		}
+		return &e.value;
+	}
+
+	constexpr auto begin() const noexcept
+	{
+		return this->entries.begin();
+	}
+
+	constexpr auto end() const noexcept
+	{
+		return this->entries.end();
+	}
+
+	constexpr static size_t size() noexcept
+	{
+		return num_entries;
+	}
+};
+
+/**
+ * @brief Create perfect hash map.
+ * Helper function which deduces number of entries from the initializer list.
+ * Intended to be used for initializing constexpr maps:
+ * @code{.cpp}
+ * constexpr auto map = make_perfect_hash_map<int>({{"one", 1}, {"two", 2}});
+ * @endcode
+ * @param entries - key-value pairs of the map.
+ * @return perfect hash map.
+ */
+template <typename value_type, size_t num_entries>
+constexpr perfect_hash_map<value_type, num_entries> make_perfect_hash_map(
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, modernize-avoid-c-arrays)
+	const std::pair<std::string_view, value_type> (&entries)[num_entries]
+)
+{
+	return perfect_hash_map<value_type, num_entries>(entries);
+}
+
+} // namespace svgdom
@@ -0,0 +1,338 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "pipelined_loader.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <mikroxml/mikroxml.hpp>
+
+#include "parser.hxx"
+#include "spsc_ring.hxx"
+
+using namespace svgdom;
+
+namespace {
+struct token {
+	enum class type {
+		element_start,
+		element_end,
+		attribute,
+		attributes_end,
+		content,
+
+		// no more tokens
+		end
+	};
+
+	type type_v = type::end;
+
+	// element name, attribute name or content
+	std::string name;
+
+	std::string value;
+
+	bool is_empty_element = false;
+};
+} // namespace
+
+namespace {
+// the producer and the consumer spin a little before going to sleep
+constexpr unsigned num_spins = 64;
+} // namespace
+
+class pipelined_loader::impl : public mikroxml::parser
+{
+	spsc_ring<token> ring;
+
+	// The sleeping side sets its flag and re-checks the ring while holding the mutex,
+	// and the waking side checks the flag after publishing its change to the ring.
+	// The sequentially consistent fences in between guarantee that at least one of the sides
+	// sees the other's change, so a wake up notification is never missed.
+	std::mutex mutex;
+	std::condition_variable producer_wakeup;
+	std::condition_variable consumer_wakeup;
+	std::atomic<bool> producer_sleeping = false;
+	std::atomic<bool> consumer_sleeping = false;
+
+	// the parser keeps views of the allowed ids, so the options are stored along with it
+	const load_options options;
+
+	svgdom::parser builder;
+
+	// exception thrown while building the document
+	std::exception_ptr error;
+
+	bool ended = false;
+
+	std::thread thread;
+
+	void wake_up(const std::atomic<bool>& sleeping, std::condition_variable& wakeup)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping.load(std::memory_order_relaxed)) {
+			// the lock makes sure that the other side has either not checked the ring yet or already waits
+			std::lock_guard lock(this->mutex);
+			wakeup.notify_one();
+		}
+	}
+
+	template <typename get_slot_type>
+	token& wait_for_slot(
+		const get_slot_type& get_slot,
+		std::atomic<bool>& sleeping,
+		std::condition_variable& wakeup
+	)
+	{
+		for (unsigned i = 0; i != num_spins; ++i) {
+			if (auto t = get_slot()) {
+				return *t;
+			}
+			std::this_thread::yield();
+		}
+
+		std::unique_lock lock(this->mutex);
+		sleeping.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		token* ret = nullptr;
+		wakeup.wait(lock, [&]() {
+			ret = get_slot();
+			return ret != nullptr;
+		});
+
+		sleeping.store(false, std::memory_order_relaxed);
+		return *ret;
+	}
+
+	token& get_free_slot()
+	{
+		return this->wait_for_slot(
+			[this]() {
+				return this->ring.get_free_slot();
+			},
+			this->producer_sleeping,
+			this->producer_wakeup
+		);
+	}
+
+	void push()
+	{
+		this->ring.push();
+		this->wake_up(this->consumer_sleeping, this->consumer_wakeup);
+	}
+
+	token& get_front_slot()
+	{
+		return this->wait_for_slot(
+			[this]() {
+				return this->ring.get_front_slot();
+			},
+			this->consumer_sleeping,
+			this->consumer_wakeup
+		);
+	}
+
+	void pop()
+	{
+		this->ring.pop();
+		this->wake_up(this->producer_sleeping, this->producer_wakeup);
+	}
+
+	void push_token(token::type type, utki::span<const char> name = {}, utki::span<const char> value = {})
+	{
+		auto& t = this->get_free_slot();
+		t.type_v = type;
+		t.name.assign(name.data(), name.size());
+		t.value.assign(value.data(), value.size());
+		this->push();
+	}
+
+	void on_element_start(utki::span<const char> name) override
+	{
+		this->push_token(token::type::element_start, name);
+	}
+
+	void on_element_end(utki::span<const char> name) override
+	{
+		this->push_token(token::type::element_end, name);
+	}
+
+	void on_attribute_parsed(utki::span<const char> name, utki::span<const char> value) override
+	{
+		this->push_token(token::type::attribute, name, value);
+	}
+
+	void on_attributes_end(bool is_empty_element) override
+	{
+		auto& t = this->get_free_slot();
+		t.type_v = token::type::attributes_end;
+		t.is_empty_element = is_empty_element;
+		this->push();
+	}
+
+	void on_content_parsed(utki::span<const char> str) override
+	{
+		this->push_token(token::type::content, str);
+	}
+
+	void build()
+	{
+		while (true) {
+			auto& t = this->get_front_slot();
+
+			if (t.type_v == token::type::end) {
+				this->pop();
+				return;
+			}
+
+			// in case of error the rest of the tokens are just dropped
+			if (!this->error) {
+				try {
+					this->dispatch(t);
+				} catch (...) {
+					this->error = std::current_exception();
+				}
+			}
+
+			this->pop();
+		}
+	}
+
+	void dispatch(const token& t)
+	{
+		auto& b = this->builder;
+		switch (t.type_v) {
+			case token::type::element_start:
+				b.on_element_start(utki::make_span(t.name));
+				break;
+			case token::type::element_end:
+				b.on_element_end(utki::make_span(t.name));
+				break;
+			case token::type::attribute:
+				b.on_attribute_parsed(utki::make_span(t.name), utki::make_span(t.value));
+				break;
+			case token::type::attributes_end:
+				b.on_attributes_end(t.is_empty_element);
+				break;
+			case token::type::content:
+				b.on_content_parsed(utki::make_span(t.name));
+				break;
+			case token::type::end:
+				ASSERT(false)
+				break;
+		}
+	}
+
+	void stop()
+	{
+		if (this->ended) {
+			return;
+		}
+		this->ended = true;
+		this->push_token(token::type::end);
+		this->thread.join();
+	}
+
+public:
+	constexpr static size_t ring_size = 4096;
+
+	impl(const load_options& options) :
+		ring(ring_size),
+		options(options)
+	{
+		this->builder.set_options(this->options);
+		this->thread = std::thread([this]() {
+			this->build();
+		});
+	}
+
+	impl(const impl&) = delete;
+	impl& operator=(const impl&) = delete;
+
+	impl(impl&&) = delete;
+	impl& operator=(impl&&) = delete;
+
+	~impl() override
+	{
+		this->stop();
+	}
+
+	std::unique_ptr<svg_element> finish()
+	{
+		if (this->ended) {
+			throw std::logic_error("pipelined_loader::end(): loading has already ended");
+		}
+
+		// flush the tokenizer, stop the building thread even if it throws
+		try {
+			this->end();
+		} catch (...) {
+			this->stop();
+			throw;
+		}
+		this->stop();
+
+		if (this->error) {
+			std::rethrow_exception(this->error);
+		}
+
+		return this->builder.get_dom();
+	}
+};
+
+pipelined_loader::pipelined_loader(const load_options& options) :
+	pimpl(std::make_unique<impl>(options))
+{}
+
+pipelined_loader::~pipelined_loader() = default;
+
+void pipelined_loader::feed(utki::span<const char> data)
+{
+	this->pimpl->feed(data);
+}
+
+void pipelined_loader::feed(utki::span<const uint8_t> data)
+{
+	this->pimpl->feed(data);
+}
+
+void pipelined_loader::feed(std::string_view data)
+{
+	this->pimpl->feed(utki::make_span(data));
+}
+
+std::unique_ptr<svg_element> pipelined_loader::end()
+{
+	return this->pimpl->finish();
+}
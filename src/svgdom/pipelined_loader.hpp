@@ -0,0 +1,101 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include <utki/span.hpp>
+
+#include "elements/structurals.hpp"
+
+#include "load_options.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief SVG document loader which tokenizes and builds the document on separate threads.
+ * The XML data passed to feed() is tokenized on the calling thread and the tokens are passed
+ * through a lock-free ring buffer to a worker thread which builds the document.
+ * So, in case the data arrives over time, e.g. from network or from a decompressor, reading
+ * the data, tokenizing it and building the document are overlapped.
+ */
+class pipelined_loader
+{
+	class impl;
+	std::unique_ptr<impl> pimpl;
+
+public:
+	/**
+	 * @brief Create loader.
+	 * Starts the document building thread.
+	 * @param options - document loading options.
+	 */
+	explicit pipelined_loader(const load_options& options = load_options());
+
+	pipelined_loader(const pipelined_loader&) = delete;
+	pipelined_loader& operator=(const pipelined_loader&) = delete;
+
+	pipelined_loader(pipelined_loader&&) = delete;
+	pipelined_loader& operator=(pipelined_loader&&) = delete;
+
+	~pipelined_loader();
+
+	/**
+	 * @brief Feed next chunk of SVG document.
+	 * @param data - chunk of the document.
+	 * @throw mikroxml::malformed_xml - in case of malformed XML.
+	 */
+	void feed(utki::span<const char> data);
+
+	/**
+	 * @brief Feed next chunk of SVG document.
+	 * @param data - chunk of the document.
+	 * @throw mikroxml::malformed_xml - in case of malformed XML.
+	 */
+	void feed(utki::span<const uint8_t> data);
+
+	/**
+	 * @brief Feed next chunk of SVG document.
+	 * @param data - chunk of the document.
+	 * @throw mikroxml::malformed_xml - in case of malformed XML.
+	 */
+	void feed(std::string_view data);
+
+	/**
+	 * @brief Finish loading.
+	 * Waits till the document building thread has processed all the tokens.
+	 * @return loaded document.
+	 * @throw malformed_svg_error - in case the document has structural errors.
+	 * @throw std::invalid_argument - in case the document has unclosed XML tags.
+	 */
+	std::unique_ptr<svg_element> end();
+};
+
+} // namespace svgdom
@@ -0,0 +1,130 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <utki/debug.hpp>
+
+namespace svgdom {
+
+/**
+ * @brief Lock-free single producer single consumer ring buffer.
+ * The slots are allocated once and reused, the producer fills the slot in place
+ * and then publishes it. So, in case the slot type holds buffers, e.g. strings,
+ * their memory is reused as well.
+ * @tparam value_type - type of the slots.
+ */
+template <typename value_type>
+class spsc_ring
+{
+	std::vector<value_type> slots;
+	const size_t mask;
+
+	// Counters are only incremented, index of the slot is the counter value modulo capacity.
+	// Counters are on separate cache lines, since they are written by different threads.
+	constexpr static size_t cache_line_size = 64;
+
+	// number of slots read by consumer
+	alignas(cache_line_size) std::atomic<size_t> head = 0;
+
+	// number of slots written by producer
+	alignas(cache_line_size) std::atomic<size_t> tail = 0;
+
+	static size_t round_up_to_power_of_two(size_t n)
+	{
+		size_t ret = 1;
+		while (ret < n) {
+			ret <<= 1;
+		}
+		return ret;
+	}
+
+public:
+	/**
+	 * @brief Create ring buffer.
+	 * @param capacity - minimal number of slots, rounded up to a power of two.
+	 */
+	explicit spsc_ring(size_t capacity) :
+		slots(round_up_to_power_of_two(capacity)),
+		mask(slots.size() - 1)
+	{}
+
+	/**
+	 * @brief Get free slot to fill.
+	 * To be called by producer only.
+	 * @return pointer to the slot to fill.
+	 * @return nullptr if the ring buffer is full.
+	 */
+	value_type* get_free_slot() noexcept
+	{
+		auto t = this->tail.load(std::memory_order_relaxed);
+		if (t - this->head.load(std::memory_order_acquire) == this->slots.size()) {
+			return nullptr;
+		}
+		return &this->slots[t & this->mask];
+	}
+
+	/**
+	 * @brief Publish the filled slot to the consumer.
+	 * To be called by producer only, after filling the slot returned by get_free_slot().
+	 */
+	void push() noexcept
+	{
+		this->tail.fetch_add(1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Get the oldest published slot.
+	 * To be called by consumer only.
+	 * @return pointer to the slot.
+	 * @return nullptr if the ring buffer is empty.
+	 */
+	value_type* get_front_slot() noexcept
+	{
+		auto h = this->head.load(std::memory_order_relaxed);
+		if (h == this->tail.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		return &this->slots[h & this->mask];
+	}
+
+	/**
+	 * @brief Release the slot returned by get_front_slot() back to the producer.
+	 * To be called by consumer only.
+	 */
+	void pop() noexcept
+	{
+		ASSERT(this->head.load(std::memory_order_relaxed) != this->tail.load(std::memory_order_relaxed))
+		this->head.fetch_add(1, std::memory_order_release);
+	}
+};
+
+} // namespace svgdom
@@ -0,0 +1,196 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "thread_pool.hxx"
+
+#include <algorithm>
+#include <utility>
+
+#include <utki/debug.hpp>
+
+using namespace svgdom;
+
+thread_pool::thread_pool(unsigned num_threads) :
+	queues(std::max(num_threads == 0 ? std::thread::hardware_concurrency() : num_threads, 1u))
+{
+	for (size_t i = 1; i != this->queues.size(); ++i) {
+		this->threads.emplace_back([this, i]() {
+			this->thread_func(i);
+		});
+	}
+}
+
+thread_pool& thread_pool::get_shared()
+{
+	static thread_pool pool(0);
+	return pool;
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard lock(this->mutex);
+		this->quit = true;
+	}
+	this->batch_started.notify_all();
+
+	for (auto& t : this->threads) {
+		t.join();
+	}
+}
+
+bool thread_pool::pop(size_t worker, chunk& c)
+{
+	auto& q = this->queues[worker];
+	std::lock_guard lock(q.mutex);
+	if (q.chunks.empty()) {
+		return false;
+	}
+	c = q.chunks.back();
+	q.chunks.pop_back();
+	return true;
+}
+
+bool thread_pool::steal(size_t worker, chunk& c)
+{
+	for (size_t i = 1; i != this->num_workers; ++i) {
+		auto& q = this->queues[(worker + i) % this->num_workers];
+		std::lock_guard lock(q.mutex);
+		if (!q.chunks.empty()) {
+			c = q.chunks.front();
+			q.chunks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void thread_pool::work(size_t worker)
+{
+	ASSERT(this->task)
+
+	chunk c{};
+	while (this->pop(worker, c) || this->steal(worker, c)) {
+		for (size_t i = c.begin; i != c.end; ++i) {
+			try {
+				(*this->task)(i, worker);
+			} catch (...) {
+				std::lock_guard lock(this->mutex);
+				if (!this->error) {
+					this->error = std::current_exception();
+				}
+			}
+		}
+	}
+}
+
+void thread_pool::thread_func(size_t worker)
+{
+	size_t last_batch = 0;
+
+	std::unique_lock lock(this->mutex);
+	while (true) {
+		this->batch_started.wait(lock, [&]() {
+			return this->quit || this->batch_number != last_batch;
+		});
+		if (this->quit) {
+			return;
+		}
+		last_batch = this->batch_number;
+
+		// the thread does not take part in this batch
+		if (worker >= this->num_workers) {
+			continue;
+		}
+
+		lock.unlock();
+		this->work(worker);
+		lock.lock();
+
+		ASSERT(this->num_busy_threads != 0)
+		--this->num_busy_threads;
+		if (this->num_busy_threads == 0) {
+			this->batch_finished.notify_one();
+		}
+	}
+}
+
+void thread_pool::run(
+	size_t num_tasks,
+	const std::function<void(size_t task_index, size_t worker_index)>& task,
+	size_t num_workers
+)
+{
+	if (num_tasks == 0) {
+		return;
+	}
+
+	if (num_workers == 0 || num_workers > this->queues.size()) {
+		num_workers = this->queues.size();
+	}
+
+	std::lock_guard run_lock(this->run_mutex);
+
+	// several chunks per worker, so that there is something to steal
+	constexpr size_t chunks_per_worker = 8;
+	size_t chunk_size = std::max(num_tasks / (num_workers * chunks_per_worker), size_t(1));
+
+	size_t worker = 0;
+	for (size_t begin = 0; begin < num_tasks; begin += chunk_size) {
+		auto& q = this->queues[worker];
+		{
+			std::lock_guard lock(q.mutex);
+			q.chunks.push_back({begin, std::min(begin + chunk_size, num_tasks)});
+		}
+		worker = (worker + 1) % num_workers;
+	}
+
+	{
+		std::lock_guard lock(this->mutex);
+		this->task = &task;
+		this->error = nullptr;
+		this->num_workers = num_workers;
+		this->num_busy_threads = num_workers - 1;
+		++this->batch_number;
+	}
+	if (num_workers != 1) {
+		this->batch_started.notify_all();
+	}
+
+	this->work(0);
+
+	std::unique_lock lock(this->mutex);
+	this->batch_finished.wait(lock, [this]() {
+		return this->num_busy_threads == 0;
+	});
+	this->task = nullptr;
+
+	if (this->error) {
+		std::rethrow_exception(std::exchange(this->error, nullptr));
+	}
+}
@@ -0,0 +1,144 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace svgdom {
+
+/**
+ * @brief Pool of threads which execute batches of tasks.
+ * The tasks of a batch are split into chunks which are distributed among the per-thread queues.
+ * A thread takes chunks from the back of its own queue and, when the queue is empty,
+ * steals chunks from the front of the other threads' queues. This way all threads stay busy
+ * even if the tasks take very different time.
+ */
+class thread_pool
+{
+	struct chunk {
+		size_t begin;
+		size_t end;
+	};
+
+	struct worker_queue {
+		std::mutex mutex;
+		std::deque<chunk> chunks;
+	};
+
+	// one queue per worker, the thread calling run() is the worker number 0
+	std::vector<worker_queue> queues;
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable batch_started;
+	std::condition_variable batch_finished;
+
+	// batches are executed one at a time
+	std::mutex run_mutex;
+
+	const std::function<void(size_t, size_t)>* task = nullptr;
+	size_t batch_number = 0;
+	size_t num_workers = 0;
+	size_t num_busy_threads = 0;
+	bool quit = false;
+
+	std::exception_ptr error;
+
+	bool pop(size_t worker, chunk& c);
+	bool steal(size_t worker, chunk& c);
+
+	void work(size_t worker);
+
+	void thread_func(size_t worker);
+
+public:
+	/**
+	 * @brief Create thread pool.
+	 * @param num_threads - number of threads to execute tasks with, including the thread calling run().
+	 *                      0 means number of hardware threads.
+	 */
+	explicit thread_pool(unsigned num_threads);
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	thread_pool(thread_pool&&) = delete;
+	thread_pool& operator=(thread_pool&&) = delete;
+
+	~thread_pool();
+
+	/**
+	 * @brief Get number of threads.
+	 * @return number of threads executing tasks, including the thread calling run().
+	 */
+	size_t size() const noexcept
+	{
+		return this->queues.size();
+	}
+
+	/**
+	 * @brief Get process wide thread pool.
+	 * The pool has as many threads as there are hardware threads. It is created on first call
+	 * and is reused by all the loading functions which decode in parallel, so that the threads
+	 * are not created and joined on each load.
+	 * @return the shared thread pool.
+	 */
+	static thread_pool& get_shared();
+
+	/**
+	 * @brief Execute batch of tasks.
+	 * Calls task(i, worker) for each i from [0, num_tasks) and waits till all the calls are finished.
+	 * The worker argument is the index of the thread executing the task, from [0, num_workers),
+	 * so that the task can use per-thread data without synchronization.
+	 * The calling thread executes the tasks as well, its worker index is 0.
+	 * In case a task throws, the rest of the tasks are still executed and then the first
+	 * exception is rethrown.
+	 * The pool executes one batch at a time, in case run() is called by several threads
+	 * simultaneously, then the batches are executed one after another.
+	 * Tasks must not call run() of the same pool.
+	 * @param num_tasks - number of tasks.
+	 * @param task - function to execute the task by its index.
+	 * @param num_workers - maximum number of threads to execute the tasks with, including the calling thread.
+	 *                      0 means all threads of the pool. Values bigger than size() are limited to size().
+	 */
+	void run(
+		size_t num_tasks,
+		const std::function<void(size_t task_index, size_t worker_index)>& task,
+		size_t num_workers = 0
+	);
+};
+
+} // namespace svgdom
@@ -34,6 +34,8 @@ SOFTWARE.
 
 #include <utki/string.hpp>
 
+#include "number_scanner.hxx"
+
 using namespace svgdom;
 
 std::string svgdom::trim_tail(std::string_view s)
@@ -78,25 +80,18 @@ std::string svgdom::coordinate_units_to_string(coordinate_units u)
 
 r4::vector2<real> svgdom::parse_number_and_optional_number(std::string_view s, r4::vector2<real> defaults)
 {
-	r4::vector2<real> ret;
-
-	utki::string_parser p(s);
+	number_scanner p(s);
 
-	try {
-		ret[0] = p.read_number<real>();
-	} catch (std::invalid_argument&) {
+	auto number = p.read_number();
+	if (!number) {
 		return defaults;
 	}
 
 	p.skip_whitespaces_and_comma();
 
-	try {
-		ret[1] = p.read_number<real>();
-	} catch (std::invalid_argument&) {
-		ret[1] = defaults[1];
-	}
+	auto optional_number = p.read_number();
 
-	return ret;
+	return {number.value(), optional_number.value_or(defaults[1])};
 }
 
 std::string svgdom::number_and_optional_number_to_string(std::array<real, 2> non, real optional_number_default)
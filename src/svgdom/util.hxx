@@ -29,6 +29,7 @@ SOFTWARE.
 
 #include <array>
 #include <charconv>
+#include <cstdint>
 #include <string_view>
 
 #include <r4/vector.hpp>
@@ -40,6 +41,20 @@ SOFTWARE.
 
 namespace svgdom {
 
+/**
+ * @brief Count set bits.
+ * @param v - value to count set bits of.
+ * @return number of set bits.
+ */
+inline size_t count_bits(uint64_t v) noexcept
+{
+	// compilers recognize this and use single instruction where available
+	v = v - ((v >> 1) & 0x5555555555555555);
+	v = (v & 0x3333333333333333) + ((v >> 2) & 0x3333333333333333); // NOLINT
+	v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0f; // NOLINT
+	return size_t((v * 0x0101010101010101) >> 56); // NOLINT
+}
+
 std::string trim_tail(std::string_view s);
 
 std::string iri_to_local_id(std::string_view iri);
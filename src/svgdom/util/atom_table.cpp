@@ -0,0 +1,116 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "atom_table.hpp"
+
+#include <stdexcept>
+
+#include "../elements/filter.hpp"
+#include "../elements/referencing.hpp"
+#include "../elements/styleable.hpp"
+#include "../visitor.hpp"
+
+using namespace svgdom;
+
+namespace {
+class interner : virtual public svgdom::const_visitor
+{
+	atom_table& atoms;
+
+	void intern(const std::string& id)
+	{
+		if (!id.empty()) {
+			this->atoms.intern(id);
+		}
+	}
+
+public:
+	interner(atom_table& atoms) :
+		atoms(atoms)
+	{}
+
+	void default_visit(const element& e) override
+	{
+		this->intern(e.id);
+
+		if (auto s = dynamic_cast<const styleable*>(&e)) {
+			for (const auto& c : s->classes) {
+				this->intern(c);
+			}
+		}
+		if (auto r = dynamic_cast<const referencing*>(&e)) {
+			// referenced ids are interned, so that the referenced element can be found by the atom
+			this->intern(r->get_local_id_from_iri());
+		}
+		if (auto f = dynamic_cast<const filter_primitive*>(&e)) {
+			this->intern(f->result);
+		}
+		if (auto i = dynamic_cast<const inputable*>(&e)) {
+			this->intern(i->in);
+		}
+		if (auto i = dynamic_cast<const second_inputable*>(&e)) {
+			this->intern(i->in2);
+		}
+	}
+};
+} // namespace
+
+atom_table::atom_table(const svgdom::element& root)
+{
+	interner i(*this);
+	root.accept(i);
+}
+
+atom_table::atom atom_table::intern(std::string_view id)
+{
+	auto i = this->atoms.find(id);
+	if (i != this->atoms.end()) {
+		return i->second;
+	}
+
+	if (this->strings.size() >= npos) {
+		throw std::length_error("atom_table: too many identifiers");
+	}
+
+	auto a = atom(this->strings.size());
+
+	// deque does not move its elements, so the views of the strings stay valid
+	std::string_view interned = this->strings.emplace_back(id);
+	this->atoms.insert(std::make_pair(interned, a));
+
+	return a;
+}
+
+atom_table::atom atom_table::find(std::string_view id) const noexcept
+{
+	auto i = this->atoms.find(id);
+	if (i == this->atoms.end()) {
+		return npos;
+	}
+	return i->second;
+}
@@ -0,0 +1,120 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <utki/debug.hpp>
+
+#include "../elements/element.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief Table of interned identifiers of a document.
+ * Each distinct identifier string is stored in the table once and is assigned a small integer, the atom.
+ * Atoms are assigned sequentially starting from 0, so they can be used as indices of plain arrays,
+ * and two identifiers of the same table are equal if and only if their atoms are equal.
+ */
+class atom_table
+{
+public:
+	using atom = uint32_t;
+
+	/**
+	 * @brief Invalid atom.
+	 * Returned by find() in case the identifier is not in the table.
+	 */
+	constexpr static atom npos = ~atom(0);
+
+private:
+	std::deque<std::string> strings;
+	std::unordered_map<std::string_view, atom> atoms;
+
+public:
+	atom_table() = default;
+
+	/**
+	 * @brief Create atom table of the document.
+	 * Interns element ids, style classes, ids referenced by local IRIs of referencing elements,
+	 * and results and inputs of filter primitives of the document.
+	 * @param root - root element of the document.
+	 */
+	explicit atom_table(const svgdom::element& root);
+
+	// the table keeps views of its own strings
+	atom_table(const atom_table&) = delete;
+	atom_table& operator=(const atom_table&) = delete;
+
+	atom_table(atom_table&&) = default;
+	atom_table& operator=(atom_table&&) = default;
+
+	~atom_table() = default;
+
+	/**
+	 * @brief Intern identifier.
+	 * @param id - identifier to intern.
+	 * @return atom of the identifier.
+	 */
+	atom intern(std::string_view id);
+
+	/**
+	 * @brief Find atom of identifier.
+	 * @param id - identifier to find atom of.
+	 * @return atom of the identifier.
+	 * @return npos in case the identifier is not in the table.
+	 */
+	atom find(std::string_view id) const noexcept;
+
+	/**
+	 * @brief Get identifier by its atom.
+	 * @param a - atom of the identifier.
+	 * @return the identifier.
+	 */
+	const std::string& get(atom a) const noexcept
+	{
+		ASSERT(a < this->strings.size())
+		return this->strings[a];
+	}
+
+	/**
+	 * @brief Get number of atoms.
+	 * @return number of interned identifiers.
+	 */
+	size_t size() const noexcept
+	{
+		return this->strings.size();
+	}
+};
+
+} // namespace svgdom
@@ -0,0 +1,142 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "bake_css.hpp"
+
+#include <utility>
+#include <vector>
+
+#include <utki/views.hpp>
+
+#include "../visitor.hpp"
+
+#include "casters.hpp"
+#include "style_stack.hpp"
+
+using namespace svgdom;
+
+namespace {
+class style_collector : public svgdom::visitor
+{
+public:
+	std::vector<std::reference_wrapper<const svgdom::style_element>> css;
+
+	// style elements to remove
+	std::vector<std::pair<svgdom::container*, decltype(svgdom::container::children)::iterator>> style_elements;
+
+	void visit(svgdom::style_element& e) override
+	{
+		this->css.emplace_back(e);
+
+		if (this->cur_parent()) {
+			this->style_elements.emplace_back(this->cur_parent(), this->cur_iter());
+		}
+	}
+};
+
+class baker : public svgdom::visitor
+{
+	style_stack ss;
+
+	void bake(styleable& s)
+	{
+		for (size_t i = 1; i != size_t(style_property::enum_size); ++i) {
+			auto p = style_property(i);
+
+			if (s.styles.count(p) != 0) {
+				// 'style' attribute has priority over CSS
+				continue;
+			}
+
+			auto v = this->ss.get_css_style_property(p);
+			if (!v) {
+				continue;
+			}
+
+			s.styles.emplace(p, *v);
+		}
+	}
+
+public:
+	baker(utki::span<const std::reference_wrapper<const svgdom::style_element>> css)
+	{
+		// the CSS of each style element is indexed once, the index is kept by the element
+		for (const auto& c : css) {
+			this->ss.add_css(c.get());
+		}
+	}
+
+	void default_visit(svgdom::element& e) override
+	{
+		auto s = cast_to_styleable(&e);
+		if (!s) {
+			return;
+		}
+
+		style_stack::push push(this->ss, *s);
+		this->bake(*s);
+	}
+
+	void default_visit(svgdom::element& e, svgdom::container& c) override
+	{
+		auto s = cast_to_styleable(&e);
+		if (!s) {
+			this->relay_accept(c);
+			return;
+		}
+
+		style_stack::push push(this->ss, *s);
+		this->bake(*s);
+		this->relay_accept(c);
+	}
+};
+} // namespace
+
+void svgdom::bake_css(svgdom::element& root, bool remove_style_elements)
+{
+	style_collector sc;
+	root.accept(sc);
+
+	if (sc.css.empty()) {
+		return;
+	}
+
+	{
+		baker b(utki::make_span(sc.css));
+		root.accept(b);
+	}
+
+	if (!remove_style_elements) {
+		return;
+	}
+
+	// remove in reverse order, so that the iterators of not yet removed elements stay valid
+	for (const auto& se : utki::views::reverse(sc.style_elements)) {
+		se.first->children.erase(se.second);
+	}
+}
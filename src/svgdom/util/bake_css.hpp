@@ -0,0 +1,50 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include "../elements/element.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief Apply CSS of the document's style elements to the elements' styles.
+ * CSS rules of all the style elements of the document are matched against each styleable element once,
+ * and the winning declarations are written to the element's styleable::styles.
+ * Declarations of the element's own 'style' attribute take priority over the CSS ones, so these are kept as is.
+ * CSS declarations take priority over presentation attributes, as styles do, so resolved style property values
+ * remain the same, but obtaining them does not involve CSS anymore.
+ * The parsed CSS does not tell which declarations are marked as '!important', so such declarations are
+ * treated as normal ones, i.e. they do not override the element's 'style' attribute. This is the same
+ * as with style_stack and computed_styles, so the baked values agree with those.
+ * @param root - root element of the document.
+ * @param remove_style_elements - whether to remove style elements from the document after their CSS is applied.
+ */
+void bake_css(svgdom::element& root, bool remove_style_elements = false);
+
+} // namespace svgdom
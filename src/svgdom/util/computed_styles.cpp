@@ -0,0 +1,270 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "computed_styles.hpp"
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <utki/debug.hpp>
+
+#include "../elements/style.hpp"
+#include "../util.hxx"
+#include "../visitor.hpp"
+
+#include "casters.hpp"
+#include "css_index.hpp"
+
+using namespace svgdom;
+
+namespace {
+constexpr size_t num_properties = size_t(style_property::enum_size);
+
+uint64_t bit(size_t p) noexcept
+{
+	ASSERT(p < num_properties)
+	return uint64_t(1) << p;
+}
+
+class resolver : public svgdom::const_visitor
+{
+	std::vector<computed_styles::record>& records;
+	std::vector<const style_value*>& values;
+	std::unordered_map<const svgdom::element*, uint32_t>& indices;
+
+	std::vector<std::shared_ptr<const css_index>> css;
+
+	uint64_t inheritable_properties = 0;
+
+	std::vector<std::reference_wrapper<const styleable>> stack;
+
+	struct level {
+		// resolved values of the element
+		std::array<const style_value*, num_properties> computed;
+
+		// values to which the element's children resolve 'inherit',
+		// i.e. nearest declared value which is not 'inherit' itself
+		std::array<const style_value*, num_properties> inherited;
+	};
+
+	// one level per styleable ancestor
+	std::vector<level> levels;
+
+	void resolve(const styleable& s)
+	{
+		this->stack.emplace_back(s);
+
+		// declared values of the element, in the order of increasing priority:
+		// presentation attributes, CSS, 'style' attribute
+		std::array<const style_value*, num_properties> declared{};
+		uint64_t declared_properties = 0;
+
+		for (const auto& a : s.presentation_attributes) {
+			declared[size_t(a.first)] = &a.second;
+			declared_properties |= bit(size_t(a.first));
+		}
+
+		if (!this->css.empty()) {
+			styleable_stack_crawler c(utki::make_span(this->stack));
+			auto declarations = match_css(utki::make_span(this->css), c);
+
+			auto v = declarations.values.begin();
+			for (uint64_t m = declarations.presence; m != 0; m &= m - 1, ++v) {
+				auto i = count_bits((m & (~m + 1)) - 1);
+				declared[i] = *v;
+			}
+			declared_properties |= declarations.presence;
+		}
+
+		for (const auto& st : s.styles) {
+			declared[size_t(st.first)] = &st.second;
+			declared_properties |= bit(size_t(st.first));
+		}
+
+		auto& l = this->levels.emplace_back();
+		if (this->levels.size() == 1) {
+			l.computed.fill(nullptr);
+			l.inherited.fill(nullptr);
+		} else {
+			const auto& parent = this->levels[this->levels.size() - 2];
+			for (size_t i = 0; i != num_properties; ++i) {
+				l.computed[i] = (this->inheritable_properties & bit(i)) ? parent.computed[i] : nullptr;
+			}
+			l.inherited = parent.inherited;
+		}
+
+		for (uint64_t m = declared_properties & ~bit(size_t(style_property::unknown)); m != 0; m &= m - 1) {
+			auto i = count_bits((m & (~m + 1)) - 1);
+			const auto* v = declared[i];
+			ASSERT(v)
+			if (is_inherit(*v)) {
+				// parent's inherited value is still there
+				l.computed[i] = l.inherited[i];
+			} else {
+				l.computed[i] = v;
+				l.inherited[i] = v;
+			}
+		}
+
+		computed_styles::record r;
+		if (this->values.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::length_error("computed_styles: too many values");
+		}
+		r.offset = uint32_t(this->values.size());
+
+		for (size_t i = 0; i != num_properties; ++i) {
+			if (l.computed[i]) {
+				r.presence |= bit(i);
+				this->values.push_back(l.computed[i]);
+			}
+		}
+
+		this->records.push_back(r);
+	}
+
+	// returns true in case the element is styleable and its level was pushed
+	bool add(const svgdom::element& e)
+	{
+		if (this->records.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::length_error("computed_styles: too many elements");
+		}
+		this->indices.insert(std::make_pair(&e, uint32_t(this->records.size())));
+
+		auto s = cast_to_styleable(&e);
+		if (!s) {
+			// not styleable elements have no styles and are transparent for inheritance
+			computed_styles::record r;
+			r.offset = uint32_t(this->values.size());
+			this->records.push_back(r);
+			return false;
+		}
+
+		this->resolve(*s);
+		return true;
+	}
+
+	void remove()
+	{
+		this->stack.pop_back();
+		this->levels.pop_back();
+	}
+
+public:
+	resolver(
+		std::vector<computed_styles::record>& records,
+		std::vector<const style_value*>& values,
+		std::unordered_map<const svgdom::element*, uint32_t>& indices,
+		std::vector<std::shared_ptr<const css_index>> css
+	) :
+		records(records),
+		values(values),
+		indices(indices),
+		css(std::move(css))
+	{
+		for (size_t i = 0; i != num_properties; ++i) {
+			if (styleable::is_inheritable(style_property(i))) {
+				this->inheritable_properties |= bit(i);
+			}
+		}
+	}
+
+	void default_visit(const svgdom::element& e) override
+	{
+		if (this->add(e)) {
+			this->remove();
+		}
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c) override
+	{
+		bool pushed = this->add(e);
+		this->relay_accept(c);
+		if (pushed) {
+			this->remove();
+		}
+	}
+};
+} // namespace
+
+computed_styles::computed_styles(
+	const svgdom::element& root,
+	utki::span<const std::reference_wrapper<const cssom::sheet>> css
+)
+{
+	std::vector<std::shared_ptr<const css_index>> indices;
+	indices.reserve(css.size());
+	for (const auto& ss : css) {
+		indices.push_back(std::make_shared<css_index>(ss.get()));
+	}
+
+	resolver r(this->records, this->values, this->indices, std::move(indices));
+	root.accept(r);
+}
+
+computed_styles::computed_styles(
+	const svgdom::element& root,
+	utki::span<const std::reference_wrapper<const style_element>> css
+)
+{
+	std::vector<std::shared_ptr<const css_index>> indices;
+	indices.reserve(css.size());
+	for (const auto& e : css) {
+		indices.push_back(e.get().get_css_index());
+	}
+
+	resolver r(this->records, this->values, this->indices, std::move(indices));
+	root.accept(r);
+}
+
+const style_value* computed_styles::get(node_table::handle h, style_property p) const noexcept
+{
+	if (h >= this->records.size()) {
+		return nullptr;
+	}
+
+	const auto& r = this->records[h];
+
+	auto b = bit(size_t(p));
+	if (!(r.presence & b)) {
+		return nullptr;
+	}
+
+	return this->values[r.offset + count_bits(r.presence & (b - 1))];
+}
+
+const style_value* computed_styles::get(const svgdom::element& e, style_property p) const noexcept
+{
+	auto i = this->indices.find(&e);
+	if (i == this->indices.end()) {
+		return nullptr;
+	}
+	return this->get(i->second, p);
+}
@@ -0,0 +1,127 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <cssom/om.hpp>
+#include <utki/span.hpp>
+
+#include "../elements/element.hpp"
+#include "../elements/style.hpp"
+#include "../elements/styleable.hpp"
+
+#include "node_table.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief Computed style property values of all elements of a document.
+ * The values are resolved in a single pass over the document. The cascade of CSS, 'style' attribute,
+ * presentation attributes and inheritance is applied incrementally from parent to children,
+ * so each element's values are computed from its own declarations and its parent's computed values.
+ * The resolved values are the same as given by style_stack::get_style_property() with the element
+ * and its styleable ancestors pushed to the stack and the same CSS sheets added.
+ * The returned values point to the document's elements and CSS sheets, so these must outlive the computed styles.
+ */
+class computed_styles
+{
+public:
+	/**
+	 * @brief Computed values of one element.
+	 * Bit number N of the presence bitmap is set in case value of the property N is specified.
+	 * The values of present properties are stored in the values array, in the order of properties,
+	 * starting from the offset.
+	 */
+	struct record {
+		uint64_t presence = 0;
+		uint32_t offset = 0;
+	};
+
+	/**
+	 * @brief Compute styles of the document.
+	 * @param root - root element of the document.
+	 * @param css - CSS sheets to apply. In case of equal specificity, the rule of the earlier sheet wins,
+	 *              as with style_stack::add_css().
+	 */
+	computed_styles(
+		const svgdom::element& root,
+		utki::span<const std::reference_wrapper<const cssom::sheet>> css = {}
+	);
+
+	/**
+	 * @brief Compute styles of the document.
+	 * Same as computed_styles(const svgdom::element&, utki::span<const std::reference_wrapper<const cssom::sheet>>)
+	 * with the CSS sheets of the style elements, but reuses the style elements' indices of the CSS rules.
+	 * @param root - root element of the document.
+	 * @param css - style elements to apply the CSS of, in the same order as the sheets would be.
+	 */
+	computed_styles(const svgdom::element& root, utki::span<const std::reference_wrapper<const style_element>> css);
+
+	/**
+	 * @brief Get computed style property value.
+	 * @param h - handle of the element, in the node_table built from the same document.
+	 * @param p - style property to get value of.
+	 * @return computed value of the property.
+	 * @return nullptr in case the property is not specified for the element or the element is not styleable.
+	 */
+	const style_value* get(node_table::handle h, style_property p) const noexcept;
+
+	/**
+	 * @brief Get computed style property value.
+	 * @param e - element of the document.
+	 * @param p - style property to get value of.
+	 * @return computed value of the property.
+	 * @return nullptr in case the property is not specified for the element, the element is not styleable
+	 *         or the element is not from the document.
+	 */
+	const style_value* get(const svgdom::element& e, style_property p) const noexcept;
+
+	/**
+	 * @brief Get number of elements.
+	 * @return number of elements of the document.
+	 */
+	size_t size() const noexcept
+	{
+		return this->records.size();
+	}
+
+private:
+	// in document order, same as in node_table
+	std::vector<record> records;
+
+	std::vector<const style_value*> values;
+
+	std::unordered_map<const svgdom::element*, uint32_t> indices;
+};
+
+} // namespace svgdom
@@ -0,0 +1,308 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "css_index.hpp"
+
+#include <array>
+#include <iterator>
+#include <stdexcept>
+
+#include <utki/debug.hpp>
+
+#include "../elements/style.hpp"
+#include "../util.hxx"
+
+using namespace svgdom;
+
+namespace {
+bool is_universal_tag(std::string_view tag)
+{
+	return tag.empty() || tag == "*";
+}
+} // namespace
+
+css_index::bucket& css_index::get_bucket(std::unordered_map<std::string_view, bucket>& buckets, std::string_view key)
+{
+	auto i = buckets.find(key);
+	if (i != buckets.end()) {
+		return i->second;
+	}
+
+	std::string_view stored_key = this->keys.emplace_back(key);
+	return buckets[stored_key];
+}
+
+css_index::css_index(const cssom::sheet& sheet) :
+	rules(sheet.styles.size())
+{
+	for (size_t position = 0; position != sheet.styles.size(); ++position) {
+		const auto& s = sheet.styles[position];
+
+		// rules are matched by querying one of their properties, so the rules without properties are not indexed
+		if (!s.properties || s.properties->empty() || s.selectors.empty()) {
+			continue;
+		}
+
+		static_assert(size_t(style_property::enum_size) <= sizeof(properties) * 8, "style properties do not fit into bitmap");
+		for (const auto& p : *s.properties) {
+			if (p.first < size_t(style_property::enum_size)) {
+				this->properties |= uint64_t(1) << p.first;
+			}
+		}
+
+		const auto& rightmost = s.selectors.back();
+
+		auto& bucket = [&]() -> css_index::bucket& {
+			if (!rightmost.id.empty()) {
+				return this->get_bucket(this->ids, rightmost.id);
+			}
+			if (!rightmost.classes.empty()) {
+				return this->get_bucket(this->classes, rightmost.classes.front());
+			}
+			if (!is_universal_tag(rightmost.tag)) {
+				return this->get_bucket(this->tags, rightmost.tag);
+			}
+			return this->universal;
+		}();
+
+		// the property list is shared, so the values returned by the rule's sheet are the values of the indexed sheet
+		this->rules[position].styles.push_back(s);
+		bucket.push_back(position);
+	}
+}
+
+cssom::sheet::query_result css_index::get_property_value(cssom::xml_dom_crawler& crawler, uint32_t property_id) const
+{
+	cssom::sheet::query_result ret;
+	size_t ret_position = 0;
+
+	auto query = [&](const bucket& b) {
+		for (auto position : b) {
+			auto r = this->rules[position].get_property_value(crawler, property_id);
+			if (!r.value) {
+				continue;
+			}
+
+			// the highest specificity wins, in case of equal specificity the rule which comes first in the sheet wins
+			if (ret.value) {
+				if (r.specificity < ret.specificity) {
+					continue;
+				}
+				if (r.specificity == ret.specificity && position > ret_position) {
+					continue;
+				}
+			}
+
+			ret = r;
+			ret_position = position;
+		}
+	};
+
+	auto query_bucket = [&](const std::unordered_map<std::string_view, bucket>& buckets, std::string_view key) {
+		auto i = buckets.find(key);
+		if (i != buckets.end()) {
+			query(i->second);
+		}
+	};
+
+	crawler.reset();
+	const auto& e = crawler.get();
+
+	if (!this->ids.empty()) {
+		auto id = e.get_id();
+		if (!id.empty()) {
+			query_bucket(this->ids, id);
+		}
+	}
+
+	if (!this->classes.empty()) {
+		for (const auto& c : e.get_classes()) {
+			query_bucket(this->classes, c);
+		}
+	}
+
+	if (!this->tags.empty()) {
+		query_bucket(this->tags, e.get_tag());
+	}
+
+	if (!this->universal.empty()) {
+		query(this->universal);
+	}
+
+	return ret;
+}
+
+void css_index::match(
+	cssom::xml_dom_crawler& crawler,
+	const std::function<void(const cssom::style& rule, size_t position)>& on_match
+) const
+{
+	auto match_bucket = [&](const bucket& b) {
+		for (auto position : b) {
+			const auto& rule_sheet = this->rules[position];
+			ASSERT(rule_sheet.styles.size() == 1)
+			const auto& rule = rule_sheet.styles.front();
+			ASSERT(rule.properties && !rule.properties->empty())
+
+			// the sheet has only this rule, so it gives a value for any property of the rule in case the rule matches
+			if (!rule_sheet.get_property_value(crawler, rule.properties->begin()->first).value) {
+				continue;
+			}
+			on_match(rule, position);
+		}
+	};
+
+	auto match_key = [&](const std::unordered_map<std::string_view, bucket>& buckets, std::string_view key) {
+		auto i = buckets.find(key);
+		if (i != buckets.end()) {
+			match_bucket(i->second);
+		}
+	};
+
+	crawler.reset();
+	const auto& e = crawler.get();
+
+	if (!this->ids.empty()) {
+		auto id = e.get_id();
+		if (!id.empty()) {
+			match_key(this->ids, id);
+		}
+	}
+
+	if (!this->classes.empty()) {
+		for (const auto& c : e.get_classes()) {
+			match_key(this->classes, c);
+		}
+	}
+
+	if (!this->tags.empty()) {
+		match_key(this->tags, e.get_tag());
+	}
+
+	match_bucket(this->universal);
+}
+
+styleable_stack_crawler::styleable_stack_crawler(decltype(stack) stack) :
+	stack(stack),
+	iter(stack.rbegin())
+{}
+
+const cssom::styleable& styleable_stack_crawler::get()
+{
+	ASSERT(!this->stack.empty())
+
+	return this->iter->get();
+}
+
+bool styleable_stack_crawler::move_up()
+{
+	if (std::distance(this->iter, this->stack.rend()) == 1) {
+		return false;
+	}
+	++this->iter;
+	return true;
+}
+
+bool styleable_stack_crawler::move_left()
+{
+	return false;
+}
+
+void styleable_stack_crawler::reset()
+{
+	if (this->stack.empty()) {
+		throw std::logic_error("styleable_stack_crawler::reset(): stack is empty");
+	}
+
+	this->iter = this->stack.rbegin();
+}
+
+const style_value* css_declarations::get(style_property p) const noexcept
+{
+	auto b = uint64_t(1) << size_t(p);
+	if (!(this->presence & b)) {
+		return nullptr;
+	}
+	ASSERT(count_bits(this->presence & (b - 1)) < this->values.size())
+	return this->values[count_bits(this->presence & (b - 1))];
+}
+
+css_declarations svgdom::match_css(
+	utki::span<const std::shared_ptr<const css_index>> css,
+	cssom::xml_dom_crawler& crawler
+)
+{
+	struct declaration {
+		const style_value* value = nullptr;
+		uint32_t specificity = 0;
+		size_t sheet = 0;
+		size_t position = 0;
+	};
+
+	std::array<declaration, size_t(style_property::enum_size)> winners;
+
+	css_declarations ret;
+
+	for (size_t sheet = 0; sheet != css.size(); ++sheet) {
+		css[sheet]->match(crawler, [&](const cssom::style& rule, size_t position) {
+			for (const auto& p : *rule.properties) {
+				if (p.first >= winners.size()) {
+					continue;
+				}
+
+				auto& w = winners[p.first];
+
+				// the sheets are matched in order, so a rule of a later sheet wins only with higher specificity
+				if (w.value) {
+					if (rule.specificity < w.specificity) {
+						continue;
+					}
+					if (rule.specificity == w.specificity && (sheet != w.sheet || position > w.position)) {
+						continue;
+					}
+				}
+
+				ASSERT(p.second)
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+				w.value = &static_cast<const style_element::css_style_value*>(p.second.get())->value;
+				w.specificity = rule.specificity;
+				w.sheet = sheet;
+				w.position = position;
+
+				ret.presence |= uint64_t(1) << p.first;
+			}
+		});
+	}
+
+	ret.values.reserve(count_bits(ret.presence));
+	for (uint64_t m = ret.presence; m != 0; m &= m - 1) {
+		ret.values.push_back(winners[count_bits((m & (~m + 1)) - 1)].value);
+	}
+
+	return ret;
+}
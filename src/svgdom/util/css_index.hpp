@@ -0,0 +1,181 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <cssom/om.hpp>
+#include <utki/span.hpp>
+
+#include "../elements/styleable.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief Index of CSS sheet rules.
+ * The rules are bucketed by id, class or tag of their rightmost compound selector,
+ * in that order of preference. Rules which have none of those go to the universal bucket.
+ * Matching an element only tests the rules from the buckets of the element's id, classes and tag,
+ * and from the universal bucket.
+ * Property values of the sheet must be of the style_element::css_style_value type.
+ * The index does not refer to the indexed sheet, but it shares the property lists of the sheet's rules,
+ * so the returned values stay valid as long as the index exists. In case the sheet is modified,
+ * the index has to be rebuilt.
+ */
+class css_index
+{
+public:
+	/**
+	 * @brief Build index of a CSS sheet.
+	 * @param sheet - CSS sheet to build index of.
+	 */
+	css_index(const cssom::sheet& sheet);
+
+	css_index(const css_index&) = delete;
+	css_index& operator=(const css_index&) = delete;
+
+	css_index(css_index&&) = default;
+	css_index& operator=(css_index&&) = default;
+
+	~css_index() = default;
+
+	/**
+	 * @brief Get value of a property for an element.
+	 * Same as cssom::sheet::get_property_value() of the indexed sheet.
+	 * @param crawler - crawler of the element to get the property value for.
+	 * @param property_id - id of the property to get value of.
+	 * @return query result, the value points to the property value of the indexed sheet.
+	 */
+	cssom::sheet::query_result get_property_value(cssom::xml_dom_crawler& crawler, uint32_t property_id) const;
+
+	/**
+	 * @brief Find rules of the sheet matching an element.
+	 * Each rule which might match the element, according to the buckets, is matched once.
+	 * @param crawler - crawler of the element to find matching rules for.
+	 * @param on_match - called for each matching rule, with the rule and its position in the indexed sheet.
+	 *                   The rules are reported in no particular order.
+	 */
+	void match(
+		cssom::xml_dom_crawler& crawler,
+		const std::function<void(const cssom::style& rule, size_t position)>& on_match
+	) const;
+
+	/**
+	 * @brief Get properties set by the sheet.
+	 * @return bitmap of the properties, bit number N is set in case the sheet has a rule which sets the property N.
+	 */
+	uint64_t get_properties() const noexcept
+	{
+		return this->properties;
+	}
+
+private:
+	// storage for the bucket keys
+	std::deque<std::string> keys;
+
+	// One sheet per rule of the indexed sheet, at the same position. Each sheet holds a single rule
+	// which shares its property list with the rule of the indexed sheet.
+	std::vector<cssom::sheet> rules;
+
+	// positions of the rules, in the same order as in the indexed sheet
+	using bucket = std::vector<size_t>;
+
+	std::unordered_map<std::string_view, bucket> ids;
+	std::unordered_map<std::string_view, bucket> classes;
+	std::unordered_map<std::string_view, bucket> tags;
+	bucket universal;
+
+	uint64_t properties = 0;
+
+	bucket& get_bucket(std::unordered_map<std::string_view, bucket>& buckets, std::string_view key);
+};
+
+/**
+ * @brief CSS crawler over a stack of styleable elements.
+ * The last element of the stack is the element being matched, the rest are its ancestors.
+ * Siblings are not known to the crawler, so the sibling combinators never match.
+ */
+class styleable_stack_crawler : public cssom::xml_dom_crawler
+{
+	utki::span<const std::reference_wrapper<const styleable>> stack;
+
+	decltype(stack)::reverse_iterator iter;
+
+public:
+	/**
+	 * @brief Create crawler.
+	 * @param stack - stack of elements, the element being matched is the last one.
+	 *                The stack must outlive the crawler.
+	 */
+	styleable_stack_crawler(decltype(stack) stack);
+
+	const cssom::styleable& get() override;
+
+	bool move_up() override;
+	bool move_left() override;
+	void reset() override;
+};
+
+/**
+ * @brief Winning CSS declarations of an element.
+ * Bit number N of the presence bitmap is set in case a CSS rule sets the property N for the element.
+ * The values of present properties are stored in the values array, in the order of properties.
+ */
+struct css_declarations {
+	uint64_t presence = 0;
+	std::vector<const style_value*> values;
+
+	/**
+	 * @brief Get value of a property.
+	 * @param p - property to get value of.
+	 * @return value of the property from the winning CSS rule.
+	 * @return nullptr in case none of the CSS rules set the property for the element.
+	 */
+	const style_value* get(style_property p) const noexcept;
+};
+
+/**
+ * @brief Match CSS rules to an element.
+ * Each rule is matched to the element once, and the winning declarations of all properties are collected.
+ * The rule with the highest specificity wins. In case of equal specificity, the rule of the earlier sheet wins,
+ * and within a sheet the rule which comes first in the sheet wins.
+ * @param css - indices of the CSS sheets to take into account.
+ * @param crawler - crawler of the element to match the rules to.
+ * @return winning declarations of the element.
+ */
+css_declarations match_css(utki::span<const std::shared_ptr<const css_index>> css, cssom::xml_dom_crawler& crawler);
+
+} // namespace svgdom
@@ -40,19 +40,30 @@ private:
 	void add_to_cache(const svgdom::element& e, const svgdom::styleable& s)
 	{
 		for (const auto& class_name : s.classes) {
-			auto it = cache.find(class_name);
+			auto a = this->atoms.intern(class_name);
+			if (a >= this->cache.size()) {
+				this->cache.resize(size_t(a) + 1);
+			}
 
-			if (it != cache.end()) {
-				it->second.push_back(&e);
-			} else {
-				std::vector<const element*> elements = {&e};
-				cache.insert(std::make_pair(class_name, std::move(elements)));
+			auto& elements = this->cache[a];
+			if (elements.empty()) {
+				++this->num_classes;
 			}
+			elements.push_back(&e);
 		}
 	}
 
 public:
-	std::unordered_map<std::string, std::vector<const element*>> cache;
+	atom_table& atoms;
+
+	std::vector<std::vector<const element*>>& cache;
+	size_t& num_classes;
+
+	cache_creator(atom_table& atoms, std::vector<std::vector<const element*>>& cache, size_t& num_classes) :
+		atoms(atoms),
+		cache(cache),
+		num_classes(num_classes)
+	{}
 
 	void visit_container(const svgdom::element& e, const svgdom::container& c, const svgdom::styleable& s)
 	{
@@ -158,14 +169,17 @@ public:
 } // namespace
 
 finder_by_class::finder_by_class(const svgdom::element& root) :
-	cache([&root]() {
-		cache_creator cc;
+	finder_by_class(root, std::make_shared<atom_table>())
+{}
 
-		root.accept(cc);
+finder_by_class::finder_by_class(const svgdom::element& root, std::shared_ptr<atom_table> atoms) :
+	atoms(std::move(atoms))
+{
+	ASSERT(this->atoms)
 
-		return std::move(cc.cache);
-	}())
-{}
+	cache_creator cc(*this->atoms, this->cache, this->num_classes);
+	root.accept(cc);
+}
 
 utki::span<const svgdom::element* const> finder_by_class::find(const std::string& class_name) const noexcept
 {
@@ -173,10 +187,5 @@ utki::span<const svgdom::element* const> finder_by_class::find(const std::string
 		return {};
 	}
 
-	auto i = this->cache.find(class_name);
-	if (i == this->cache.end()) {
-		return {};
-	}
-
-	return utki::make_span(i->second);
+	return this->find(this->atoms->find(class_name));
 }
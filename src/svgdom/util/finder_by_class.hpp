@@ -27,34 +27,76 @@ SOFTWARE.
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include <utki/span.hpp>
 
 #include "../elements/element.hpp"
 
+#include "atom_table.hpp"
 #include "style_stack.hpp"
 
 namespace svgdom {
 
+/**
+ * @brief Finder of elements by style class.
+ * The class names are interned into an atom table and the element lists are kept in an array
+ * indexed by the class name atoms.
+ */
 class finder_by_class
 {
 public:
 	finder_by_class(const svgdom::element& root);
 
+	/**
+	 * @brief Create finder sharing atom table with other finders.
+	 * The class names of the document are interned into the given atom table.
+	 * @param root - root element of the document.
+	 * @param atoms - atom table to use.
+	 */
+	finder_by_class(const svgdom::element& root, std::shared_ptr<atom_table> atoms);
+
 	utki::span<const element* const> find(const std::string& cls) const noexcept;
 
+	/**
+	 * @brief Find elements by class name atom.
+	 * @param cls - atom of the class name from the finder's atom table.
+	 * @return elements having the given class, in document order.
+	 */
+	utki::span<const element* const> find(atom_table::atom cls) const noexcept
+	{
+		if (cls >= this->cache.size()) {
+			return {};
+		}
+		return utki::make_span(this->cache[cls]);
+	}
+
+	/**
+	 * @brief Get atom table of the finder.
+	 * @return atom table.
+	 */
+	const atom_table& get_atoms() const noexcept
+	{
+		return *this->atoms;
+	}
+
 	/**
 	 * @brief Get elements-by-class-name cache size.
 	 * @return number of cached elements.
 	 */
 	size_t size() const noexcept
 	{
-		return this->cache.size();
+		return this->num_classes;
 	}
 
 private:
-	std::unordered_map<std::string, std::vector<const element*>> cache;
+	std::shared_ptr<atom_table> atoms;
+
+	// indexed by class name atom
+	std::vector<std::vector<const element*>> cache;
+
+	size_t num_classes = 0;
 };
 
 } // namespace svgdom
@@ -39,13 +39,33 @@ class cache_creator : virtual public svgdom::const_visitor
 private:
 	void add_to_cache(const svgdom::element& e)
 	{
-		if (!e.id.empty()) {
-			this->cache.insert(std::make_pair(e.id, &e));
+		if (e.id.empty()) {
+			return;
+		}
+
+		auto a = this->atoms.intern(e.id);
+		if (a >= this->cache.size()) {
+			this->cache.resize(size_t(a) + 1, nullptr);
+		}
+
+		// in case of duplicate ids the first element wins
+		if (!this->cache[a]) {
+			this->cache[a] = &e;
+			++this->num_elements;
 		}
 	}
 
 public:
-	std::unordered_map<std::string, const element*> cache;
+	atom_table& atoms;
+
+	std::vector<const element*>& cache;
+	size_t& num_elements;
+
+	cache_creator(atom_table& atoms, std::vector<const element*>& cache, size_t& num_elements) :
+		atoms(atoms),
+		cache(cache),
+		num_elements(num_elements)
+	{}
 
 	void default_visit(const element& e) override
 	{
@@ -55,14 +75,17 @@ public:
 } // namespace
 
 finder_by_id::finder_by_id(const svgdom::element& root) :
-	cache([&root]() {
-		cache_creator cc;
+	finder_by_id(root, std::make_shared<atom_table>())
+{}
 
-		root.accept(cc);
+finder_by_id::finder_by_id(const svgdom::element& root, std::shared_ptr<atom_table> atoms) :
+	atoms(std::move(atoms))
+{
+	ASSERT(this->atoms)
 
-		return std::move(cc.cache);
-	}())
-{}
+	cache_creator cc(*this->atoms, this->cache, this->num_elements);
+	root.accept(cc);
+}
 
 const svgdom::element* finder_by_id::find(const std::string& id) const noexcept
 {
@@ -70,10 +93,5 @@ const svgdom::element* finder_by_id::find(const std::string& id) const noexcept
 		return nullptr;
 	}
 
-	auto i = this->cache.find(id);
-	if (i == this->cache.end()) {
-		return nullptr;
-	}
-
-	return i->second;
+	return this->find(this->atoms->find(id));
 }
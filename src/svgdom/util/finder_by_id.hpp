@@ -27,32 +27,75 @@ SOFTWARE.
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "../elements/element.hpp"
 
+#include "atom_table.hpp"
 #include "style_stack.hpp"
 
 namespace svgdom {
 
+/**
+ * @brief Finder of elements by id.
+ * The ids are interned into an atom table and the elements are kept in an array indexed by the id atoms.
+ * So, finding an element by id string takes one hash table lookup, and finding by id atom is an array access.
+ */
 class finder_by_id
 {
 public:
 	finder_by_id(const svgdom::element& root);
 
+	/**
+	 * @brief Create finder sharing atom table with other finders.
+	 * The ids of the document are interned into the given atom table.
+	 * @param root - root element of the document.
+	 * @param atoms - atom table to use.
+	 */
+	finder_by_id(const svgdom::element& root, std::shared_ptr<atom_table> atoms);
+
 	const element* find(const std::string& id) const noexcept;
 
+	/**
+	 * @brief Find element by id atom.
+	 * @param id - atom of the id from the finder's atom table.
+	 * @return element with the given id.
+	 * @return nullptr in case there is no element with the given id.
+	 */
+	const element* find(atom_table::atom id) const noexcept
+	{
+		if (id >= this->cache.size()) {
+			return nullptr;
+		}
+		return this->cache[id];
+	}
+
+	/**
+	 * @brief Get atom table of the finder.
+	 * @return atom table.
+	 */
+	const atom_table& get_atoms() const noexcept
+	{
+		return *this->atoms;
+	}
+
 	/**
 	 * @brief Get element-by-id cache size.
 	 * @return number of cached elements.
 	 */
 	size_t size() const noexcept
 	{
-		return this->cache.size();
+		return this->num_elements;
 	}
 
 private:
-	std::unordered_map<std::string, const element*> cache;
+	std::shared_ptr<atom_table> atoms;
+
+	// indexed by id atom
+	std::vector<const element*> cache;
+
+	size_t num_elements = 0;
 };
 
 } // namespace svgdom
@@ -0,0 +1,239 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "node_table.hpp"
+
+#include <stdexcept>
+
+#include "../visitor.hpp"
+
+using namespace svgdom;
+
+namespace {
+class table_builder : public svgdom::const_visitor
+{
+	std::vector<node_table::node>& nodes;
+
+	node_table::handle parent = node_table::npos;
+	node_table::handle last_child = node_table::npos;
+	uint32_t depth = 0;
+
+	void add(const svgdom::element& e, element_kind kind)
+	{
+		if (this->nodes.size() >= node_table::npos) {
+			throw std::length_error("node_table: too many elements in the document");
+		}
+
+		auto h = node_table::handle(this->nodes.size());
+
+		node_table::node n;
+		n.kind = kind;
+		n.parent = this->parent;
+		n.depth = this->depth;
+		n.element = &e;
+		this->nodes.push_back(n);
+
+		if (this->last_child != node_table::npos) {
+			this->nodes[this->last_child].next_sibling = h;
+		} else if (this->parent != node_table::npos) {
+			this->nodes[this->parent].first_child = h;
+		}
+		this->last_child = h;
+	}
+
+	void add(const svgdom::element& e, const container& c, element_kind kind)
+	{
+		this->add(e, kind);
+
+		auto old_parent = this->parent;
+		auto old_last_child = this->last_child;
+
+		this->parent = this->last_child;
+		this->last_child = node_table::npos;
+		++this->depth;
+
+		this->relay_accept(c);
+
+		--this->depth;
+		this->parent = old_parent;
+		this->last_child = old_last_child;
+	}
+
+public:
+	table_builder(std::vector<node_table::node>& nodes) :
+		nodes(nodes)
+	{}
+
+	void visit(const path_element& e) override
+	{
+		this->add(e, element_kind::path);
+	}
+
+	void visit(const rect_element& e) override
+	{
+		this->add(e, element_kind::rect);
+	}
+
+	void visit(const circle_element& e) override
+	{
+		this->add(e, element_kind::circle);
+	}
+
+	void visit(const ellipse_element& e) override
+	{
+		this->add(e, element_kind::ellipse);
+	}
+
+	void visit(const line_element& e) override
+	{
+		this->add(e, element_kind::line);
+	}
+
+	void visit(const polyline_element& e) override
+	{
+		this->add(e, element_kind::polyline);
+	}
+
+	void visit(const polygon_element& e) override
+	{
+		this->add(e, element_kind::polygon);
+	}
+
+	void visit(const g_element& e) override
+	{
+		this->add(e, e, element_kind::g);
+	}
+
+	void visit(const svg_element& e) override
+	{
+		this->add(e, e, element_kind::svg);
+	}
+
+	void visit(const symbol_element& e) override
+	{
+		this->add(e, e, element_kind::symbol);
+	}
+
+	void visit(const use_element& e) override
+	{
+		this->add(e, element_kind::use);
+	}
+
+	void visit(const defs_element& e) override
+	{
+		this->add(e, e, element_kind::defs);
+	}
+
+	void visit(const gradient::stop_element& e) override
+	{
+		this->add(e, element_kind::gradient_stop);
+	}
+
+	void visit(const linear_gradient_element& e) override
+	{
+		this->add(e, e, element_kind::linear_gradient);
+	}
+
+	void visit(const radial_gradient_element& e) override
+	{
+		this->add(e, e, element_kind::radial_gradient);
+	}
+
+	void visit(const filter_element& e) override
+	{
+		this->add(e, e, element_kind::filter);
+	}
+
+	void visit(const fe_gaussian_blur_element& e) override
+	{
+		this->add(e, element_kind::fe_gaussian_blur);
+	}
+
+	void visit(const fe_color_matrix_element& e) override
+	{
+		this->add(e, element_kind::fe_color_matrix);
+	}
+
+	void visit(const fe_blend_element& e) override
+	{
+		this->add(e, element_kind::fe_blend);
+	}
+
+	void visit(const fe_composite_element& e) override
+	{
+		this->add(e, element_kind::fe_composite);
+	}
+
+	void visit(const image_element& e) override
+	{
+		this->add(e, element_kind::image);
+	}
+
+	void visit(const mask_element& e) override
+	{
+		this->add(e, e, element_kind::mask);
+	}
+
+	void visit(const text_element& e) override
+	{
+		this->add(e, e, element_kind::text);
+	}
+
+	void visit(const style_element& e) override
+	{
+		this->add(e, element_kind::style);
+	}
+
+	// custom elements
+	void default_visit(const svgdom::element& e) override
+	{
+		this->add(e, element_kind::enum_size);
+	}
+
+	void default_visit(const svgdom::element& e, const container& c) override
+	{
+		this->add(e, c, element_kind::enum_size);
+	}
+};
+} // namespace
+
+node_table::node_table(const svgdom::element& root)
+{
+	table_builder builder(this->nodes);
+	root.accept(builder);
+}
+
+node_table::handle node_table::find(const svgdom::element& e) const noexcept
+{
+	for (const auto& n : this->nodes) {
+		if (n.element == &e) {
+			return handle(&n - this->nodes.data());
+		}
+	}
+	return npos;
+}
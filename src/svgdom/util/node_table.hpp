@@ -0,0 +1,143 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <utki/debug.hpp>
+#include <utki/span.hpp>
+
+#include "../elements/element.hpp"
+#include "../load_options.hpp"
+
+namespace svgdom {
+
+/**
+ * @brief Flat table of document nodes.
+ * The table is a contiguous array of node records, one record per element of the document,
+ * stored in document order, i.e. parent goes before its children and the children go in the order
+ * they appear in the document. Each record refers to its parent, first child and next sibling by
+ * the index of their record in the table, so navigation up and along the siblings is O(1)
+ * and traversing the whole document is a linear pass over the array.
+ * The record indices are used as handles to the nodes, they stay valid as long as the table exists.
+ * The table does not own the elements, so the document must outlive the table.
+ */
+class node_table
+{
+public:
+	/**
+	 * @brief Handle of a node, the index of the node's record in the table.
+	 */
+	using handle = uint32_t;
+
+	/**
+	 * @brief Invalid handle.
+	 * Used in node records to indicate absence of the parent, child or sibling node.
+	 */
+	constexpr static handle npos = ~handle(0);
+
+	struct node {
+		/**
+		 * @brief Kind of the element.
+		 * element_kind::enum_size for custom elements not known to svgdom.
+		 */
+		element_kind kind = element_kind::enum_size;
+
+		handle parent = npos;
+		handle first_child = npos;
+		handle next_sibling = npos;
+
+		/**
+		 * @brief Nesting depth of the element.
+		 * 0 for the root element.
+		 */
+		uint32_t depth = 0;
+
+		const svgdom::element* element = nullptr;
+	};
+
+	/**
+	 * @brief Build node table of the document.
+	 * @param root - root element of the document.
+	 */
+	node_table(const svgdom::element& root);
+
+	/**
+	 * @brief Get handle of the root node.
+	 * @return handle of the root node.
+	 */
+	constexpr static handle root() noexcept
+	{
+		return 0;
+	}
+
+	/**
+	 * @brief Get number of nodes.
+	 * @return number of nodes in the table.
+	 */
+	size_t size() const noexcept
+	{
+		return this->nodes.size();
+	}
+
+	/**
+	 * @brief Get node record.
+	 * @param h - handle of the node.
+	 * @return node record.
+	 */
+	const node& operator[](handle h) const noexcept
+	{
+		ASSERT(h < this->nodes.size())
+		return this->nodes[h];
+	}
+
+	/**
+	 * @brief Get all node records.
+	 * @return node records in document order.
+	 */
+	utki::span<const node> get_nodes() const noexcept
+	{
+		return utki::make_span(this->nodes);
+	}
+
+	/**
+	 * @brief Find node of the element.
+	 * Linear search over the table.
+	 * @param e - element to find the node of.
+	 * @return handle of the element's node.
+	 * @return npos in case the element is not in the table.
+	 */
+	handle find(const svgdom::element& e) const noexcept;
+
+private:
+	std::vector<node> nodes;
+};
+
+} // namespace svgdom
@@ -279,7 +279,11 @@ void stream_writer::visit(const image_element& e)
 			length(0, length_unit::number)
 		)
 	);
-	this->add_referencing_attributes(e);
+	if (e.data.has_value() && e.iri.empty()) {
+		this->add_attribute("xlink:href", e.data->to_string());
+	} else {
+		this->add_referencing_attributes(e);
+	}
 	this->add_aspect_ratioed_attributes(e);
 	this->write();
 }
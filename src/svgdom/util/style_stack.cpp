@@ -27,6 +27,9 @@ SOFTWARE.
 
 #include "style_stack.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 #include <utki/debug.hpp>
 #include <utki/util.hpp>
 #include <utki/views.hpp>
@@ -35,44 +38,6 @@ SOFTWARE.
 
 using namespace svgdom;
 
-style_stack::crawler::crawler(decltype(stack) stack) :
-	stack(stack)
-{}
-
-const cssom::styleable& style_stack::crawler::get()
-{
-	ASSERT(!this->stack.empty())
-
-	return this->iter->get();
-}
-
-bool style_stack::crawler::move_up()
-{
-	// TRACE(<< "crawler::move_up(): stack.size() = " << this->stack.size() << std::endl)
-	if (std::distance(this->iter, this->stack.rend()) == 1) {
-		// TRACE(<< "crawler::move_up(): at root node" << std::endl)
-		return false;
-	}
-	++this->iter;
-	return true;
-}
-
-bool style_stack::crawler::move_left()
-{
-	// TRACE(<< "crawler::move_left(): NOT SUPPORTED!!!" << std::endl)
-	return false;
-}
-
-void style_stack::crawler::reset()
-{
-	// TRACE(<< "crawler::reset(): invoked" << std::endl)
-	if (this->stack.empty()) {
-		throw std::logic_error("style_stack::crawler::reset(): stack is empty");
-	}
-
-	this->iter = this->stack.rbegin();
-}
-
 const svgdom::style_value* style_stack::get_style_property(svgdom::style_property p) const
 {
 	// INFO: some guide to styling priority, not a spec.
@@ -80,6 +45,8 @@ const svgdom::style_value* style_stack::get_style_property(svgdom::style_propert
 
 	bool explicit_inherit = false;
 
+	this->sync_css_cache();
+
 	size_t stack_depth = this->stack.size();
 
 	for (const auto& styleable_ref : utki::views::reverse(this->stack)) {
@@ -128,27 +95,73 @@ style_stack::push::~push() noexcept
 
 void style_stack::add_css(const cssom::sheet& css_doc)
 {
-	this->css.emplace_back(css_doc);
+	this->add_css(std::make_shared<css_index>(css_doc));
 }
 
-const style_value* style_stack::get_css_style_property(size_t stack_depth, style_property p) const
+void style_stack::add_css(const style_element& e)
 {
-	crawler c(utki::make_span(this->stack).subspan(0, stack_depth));
-	uint32_t specificity = 0;
-	const style_value* ret = nullptr;
-
-	// later added CSSes override earlier ones, so go through them in reverse order
-	for (auto& ss : utki::views::reverse(this->css)) {
-		auto r = ss.get().get_property_value(c, uint32_t(p));
-		if (!r.value) {
-			continue;
-		}
-		if (r.specificity < specificity) {
-			continue;
+	this->add_css(e.get_css_index());
+}
+
+void style_stack::add_css(std::shared_ptr<const css_index> index)
+{
+	this->css_properties |= index->get_properties();
+	this->css.push_back(std::move(index));
+
+	// matched values might be overridden by the added CSS
+	this->css_cache.clear();
+}
+
+void style_stack::sync_css_cache() const
+{
+	if (this->css.empty()) {
+		return;
+	}
+
+	// drop entries of the elements which are not in the stack anymore
+	size_t num_valid = 0;
+	for (; num_valid != std::min(this->css_cache.size(), this->stack.size()); ++num_valid) {
+		if (this->css_cache[num_valid].element != &this->stack[num_valid].get()) {
+			break;
 		}
-		specificity = r.specificity;
-		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
-		ret = &static_cast<const style_element::css_style_value*>(r.value)->value;
 	}
-	return ret;
+	this->css_cache.erase(std::next(this->css_cache.begin(), std::ptrdiff_t(num_valid)), this->css_cache.end());
+
+	for (auto i = std::next(this->stack.begin(), std::ptrdiff_t(this->css_cache.size())); i != this->stack.end(); ++i) {
+		this->css_cache.emplace_back(i->get());
+	}
+}
+
+const style_value* style_stack::get_css_style_property(style_property p) const
+{
+	if (this->stack.empty()) {
+		return nullptr;
+	}
+
+	this->sync_css_cache();
+
+	return this->get_css_style_property(this->stack.size(), p);
+}
+
+const style_value* style_stack::get_css_style_property(size_t stack_depth, style_property p) const
+{
+	static_assert(size_t(style_property::enum_size) <= sizeof(css_properties) * 8, "style properties do not fit into bitmap");
+
+	auto property_bit = uint64_t(1) << size_t(p);
+
+	if (!(this->css_properties & property_bit)) {
+		return nullptr;
+	}
+
+	ASSERT(stack_depth != 0)
+	ASSERT(stack_depth <= this->css_cache.size())
+	auto& entry = this->css_cache[stack_depth - 1];
+
+	if (!entry.matched) {
+		styleable_stack_crawler c(utki::make_span(this->stack).subspan(0, stack_depth));
+		entry.declarations = match_css(utki::make_span(this->css), c);
+		entry.matched = true;
+	}
+
+	return entry.declarations.get(p);
 }
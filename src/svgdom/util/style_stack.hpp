@@ -27,45 +27,89 @@ SOFTWARE.
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <cssom/om.hpp>
 
 #include "../elements/container.hpp"
+#include "../elements/style.hpp"
 #include "../elements/styleable.hpp"
 
+#include "css_index.hpp"
+
 namespace svgdom {
+/**
+ * @brief Stack of styleable elements to get style properties of the top element with.
+ * CSS rules are matched to the elements lazily, on the first style property lookup, and
+ * the matches are cached inside of the stack, so even the const methods modify the stack.
+ * Hence, a style stack must not be used from several threads at the same time, not even for
+ * style property lookups only. Each thread should use its own copy of the stack.
+ */
 class style_stack
 {
 public:
 	std::vector<std::reference_wrapper<const styleable>> stack;
 
 private:
-	std::vector<std::reference_wrapper<const cssom::sheet>> css;
+	std::vector<std::shared_ptr<const css_index>> css;
 
-	class crawler : public cssom::xml_dom_crawler
-	{
-		utki::span<const decltype(style_stack::stack)::value_type> stack;
+	// properties which are set by any of the CSS sheets, only these are looked up in CSS
+	uint64_t css_properties = 0;
 
-		decltype(stack)::reverse_iterator iter;
+	// CSS declarations matched to the elements of the stack, one entry per stack level.
+	// The rules are matched lazily, once per element, on first CSS property lookup for the element,
+	// and the declarations are reused for all lookups of the element and its descendants. Cleared on add_css().
+	struct css_cache_entry {
+		const styleable* element;
 
-	public:
-		crawler(decltype(stack) stack);
+		bool matched = false;
 
-		const cssom::styleable& get() override;
+		css_declarations declarations;
 
-		bool move_up() override;
-		bool move_left() override;
-		void reset() override;
+		css_cache_entry(const styleable& element) :
+			element(&element)
+		{}
 	};
 
+	mutable std::vector<css_cache_entry> css_cache;
+
+	void sync_css_cache() const;
+
 	const svgdom::style_value* get_css_style_property(size_t stack_depth, svgdom::style_property p) const;
 
 public:
 	const svgdom::style_value* get_style_property(svgdom::style_property p) const;
 
+	/**
+	 * @brief Get value of a property set by CSS to the top element of the stack.
+	 * Only the added CSS sheets are taken into account, i.e. 'style' attribute,
+	 * presentation attributes and inheritance are not.
+	 * @param p - property to get value of.
+	 * @return value of the property from the CSS rule which wins for the top element of the stack.
+	 * @return nullptr in case the stack is empty or none of the CSS rules set the property for the top element.
+	 */
+	const svgdom::style_value* get_css_style_property(svgdom::style_property p) const;
+
 	void add_css(const cssom::sheet& css_doc);
 
+	/**
+	 * @brief Add CSS of a style element.
+	 * Same as add_css(const cssom::sheet&) with the element's css, but reuses the element's index
+	 * of the CSS rules instead of building a new one.
+	 * @param e - style element to add the CSS of.
+	 */
+	void add_css(const style_element& e);
+
+	/**
+	 * @brief Add indexed CSS.
+	 * Same as add_css(const cssom::sheet&), but reuses the already built index of the CSS rules.
+	 * @param index - index of the CSS sheet to add.
+	 */
+	void add_css(std::shared_ptr<const css_index> index);
+
 	class push
 	{
 		style_stack& ss;
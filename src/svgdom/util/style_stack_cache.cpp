@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include "style_stack_cache.hpp"
 
+#include <algorithm>
+
 #include <utki/debug.hpp>
 
 #include "../visitor.hpp"
@@ -40,25 +42,58 @@ private:
 	void add_to_cache(const svgdom::element& e)
 	{
 		if (!e.id.empty()) {
-			this->cache.insert(std::make_pair(e.id, this->current_style_stack));
+			this->cache.insert(std::make_pair(e.id, this->top));
 		}
 	}
 
-	style_stack current_style_stack;
+	// top node of the current style stack
+	const style_stack_cache::node* top = nullptr;
+
+	class push
+	{
+		cache_creator& cc;
+		const style_stack_cache::node* prev_top;
+
+	public:
+		push(cache_creator& cc, const svgdom::styleable& s) :
+			cc(cc),
+			prev_top(cc.top)
+		{
+			this->cc.nodes.push_back({&s, this->prev_top});
+			this->cc.top = &this->cc.nodes.back();
+		}
+
+		push(const push&) = delete;
+		push& operator=(const push&) = delete;
+
+		push(push&&) = delete;
+		push& operator=(push&&) = delete;
+
+		~push() noexcept
+		{
+			this->cc.top = this->prev_top;
+		}
+	};
 
 public:
-	std::unordered_map<std::string, style_stack> cache;
+	std::deque<style_stack_cache::node>& nodes;
+	std::unordered_map<std::string, const style_stack_cache::node*>& cache;
+
+	cache_creator(decltype(nodes) nodes, decltype(cache) cache) :
+		nodes(nodes),
+		cache(cache)
+	{}
 
 	void visit_container(const svgdom::element& e, const svgdom::container& c, const svgdom::styleable& s)
 	{
-		style_stack::push push(this->current_style_stack, s);
+		push p(*this, s);
 		this->add_to_cache(e);
 		this->relay_accept(c);
 	}
 
 	void visit_element(const svgdom::element& e, const svgdom::styleable& s)
 	{
-		style_stack::push push(this->current_style_stack, s);
+		push p(*this, s);
 		this->add_to_cache(e);
 	}
 
@@ -159,17 +194,13 @@ public:
 };
 } // namespace
 
-style_stack_cache::style_stack_cache(const svgdom::element& root) :
-	cache([&root]() {
-		cache_creator cc;
-
-		root.accept(cc);
-
-		return std::move(cc.cache);
-	}())
-{}
+style_stack_cache::style_stack_cache(const svgdom::element& root)
+{
+	cache_creator cc(this->nodes, this->cache);
+	root.accept(cc);
+}
 
-const style_stack* style_stack_cache::find(const std::string& id) const noexcept
+const style_stack_cache::node* style_stack_cache::find(const std::string& id) const noexcept
 {
 	if (id.length() == 0) {
 		return nullptr;
@@ -180,5 +211,17 @@ const style_stack* style_stack_cache::find(const std::string& id) const noexcept
 		return nullptr;
 	}
 
-	return &i->second;
+	return i->second;
+}
+
+style_stack style_stack_cache::node::to_style_stack() const
+{
+	style_stack ret;
+
+	for (auto n = this; n; n = n->parent) {
+		ret.stack.emplace_back(*n->element);
+	}
+	std::reverse(ret.stack.begin(), ret.stack.end());
+
+	return ret;
 }
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <deque>
 #include <unordered_map>
 
 #include "../elements/element.hpp"
@@ -38,9 +39,50 @@ namespace svgdom {
 class style_stack_cache
 {
 public:
+	/**
+	 * @brief Node of the persistent style stack.
+	 * Style stacks of all cached elements share the nodes of their common ancestors,
+	 * so the style stack of an element is the chain of nodes from the element's node to the root node.
+	 */
+	struct node {
+		/**
+		 * @brief Element of this stack level.
+		 */
+		const styleable* element;
+
+		/**
+		 * @brief Node of the parent element.
+		 * nullptr for the bottom node of the stack.
+		 */
+		const node* parent;
+
+		/**
+		 * @brief Create style stack of this node's element.
+		 * The cost is proportional to the depth of the element.
+		 * @return style stack with this node's element on top.
+		 */
+		style_stack to_style_stack() const;
+	};
+
 	style_stack_cache(const svgdom::element& root);
 
-	const style_stack* find(const std::string& id) const noexcept;
+	// the nodes point to each other, so the cache is not copyable, but movable
+	style_stack_cache(const style_stack_cache&) = delete;
+	style_stack_cache& operator=(const style_stack_cache&) = delete;
+
+	style_stack_cache(style_stack_cache&&) = default;
+	style_stack_cache& operator=(style_stack_cache&&) = default;
+
+	~style_stack_cache() = default;
+
+	/**
+	 * @brief Find style stack of an element by id.
+	 * The returned node stays valid as long as the cache exists.
+	 * @param id - id of the element to find style stack of.
+	 * @return top node of the style stack of the element with the given id.
+	 * @return nullptr in case element with the given id is not found or its style stack is empty.
+	 */
+	const node* find(const std::string& id) const noexcept;
 
 	/**
 	 * @brief Get style-stack-by-id cache size.
@@ -52,7 +94,11 @@ public:
 	}
 
 private:
-	std::unordered_map<std::string, style_stack> cache;
+	// std::deque does not move its elements when growing, so the nodes can point to each other
+	std::deque<node> nodes;
+
+	// element id -> top node of the element's style stack, nullptr for empty stack
+	std::unordered_map<std::string, const node*> cache;
 };
 
 } // namespace svgdom
@@ -0,0 +1,233 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#include "style_value_pool.hpp"
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include <utki/debug.hpp>
+
+using namespace svgdom;
+
+namespace {
+template <typename alternative_type, typename... alternative_types>
+constexpr uint8_t index_in(const std::variant<alternative_types...>*)
+{
+	constexpr std::array<bool, sizeof...(alternative_types)> matches = {
+		std::is_same_v<alternative_type, alternative_types>...
+	};
+	for (size_t i = 0; i != matches.size(); ++i) {
+		if (matches[i]) {
+			return uint8_t(i);
+		}
+	}
+	return uint8_t(matches.size());
+}
+
+template <typename alternative_type>
+constexpr uint8_t index_of()
+{
+	return index_in<alternative_type>(static_cast<const style_value*>(nullptr));
+}
+
+template <typename value_type>
+void append_bytes(std::string& key, const value_type& v)
+{
+	key.append(reinterpret_cast<const char*>(&v), sizeof(v)); // NOLINT
+}
+
+uint32_t to_index(size_t i)
+{
+	if (i > std::numeric_limits<uint32_t>::max()) {
+		throw std::length_error("style_value_pool: too many values");
+	}
+	return uint32_t(i);
+}
+} // namespace
+
+bool compact_style_value::operator==(const compact_style_value& v) const noexcept
+{
+	if (this->type != v.type) {
+		return false;
+	}
+
+	switch (this->type) {
+		case index_of<real>():
+			// the inactive union member is not compared, since it may have different bits for equal numbers
+			return this->payload.number == v.payload.number;
+		case index_of<length>():
+			return this->unit == v.unit && this->payload.number == v.payload.number;
+		default:
+			return this->payload.integer == v.payload.integer;
+	}
+}
+
+compact_style_value style_value_pool::encode(const style_value& v)
+{
+	compact_style_value ret;
+	ret.type = uint8_t(v.index());
+
+	std::visit(
+		[&](const auto& alternative) {
+			using type = std::decay_t<decltype(alternative)>;
+
+			if constexpr (std::is_same_v<type, uint32_t>) {
+				ret.payload.integer = alternative;
+			} else if constexpr (std::is_same_v<type, real>) {
+				ret.payload.number = alternative;
+			} else if constexpr (std::is_same_v<type, length>) {
+				ret.payload.number = alternative.value;
+				ret.unit = uint8_t(alternative.unit);
+			} else if constexpr (std::is_enum_v<type>) {
+				ret.payload.integer = uint32_t(alternative);
+			} else if constexpr (std::is_same_v<type, std::string>) {
+				auto i = this->string_indices.find(alternative);
+				if (i != this->string_indices.end()) {
+					ret.payload.integer = i->second;
+				} else {
+					ret.payload.integer = to_index(this->strings.size());
+					// deque does not move its elements, so the views of the strings stay valid
+					std::string_view interned = this->strings.emplace_back(alternative);
+					this->string_indices.insert(std::make_pair(interned, ret.payload.integer));
+				}
+			} else if constexpr (std::is_same_v<type, std::vector<length>>) {
+				std::string key;
+				for (const auto& l : alternative) {
+					append_bytes(key, l.value);
+					key.push_back(char(l.unit));
+				}
+				auto i = this->dash_array_indices.find(key);
+				if (i != this->dash_array_indices.end()) {
+					ret.payload.integer = i->second;
+				} else {
+					ret.payload.integer = to_index(this->dash_arrays.size());
+					this->dash_arrays.push_back(alternative);
+					this->dash_array_indices.insert(std::make_pair(std::move(key), ret.payload.integer));
+				}
+			} else {
+				static_assert(std::is_same_v<type, enable_background_property>, "unexpected style_value alternative");
+				std::string key;
+				key.push_back(char(alternative.value));
+				append_bytes(key, alternative.rect.p.x());
+				append_bytes(key, alternative.rect.p.y());
+				append_bytes(key, alternative.rect.d.x());
+				append_bytes(key, alternative.rect.d.y());
+				auto i = this->enable_background_indices.find(key);
+				if (i != this->enable_background_indices.end()) {
+					ret.payload.integer = i->second;
+				} else {
+					ret.payload.integer = to_index(this->enable_backgrounds.size());
+					this->enable_backgrounds.push_back(alternative);
+					this->enable_background_indices.insert(std::make_pair(std::move(key), ret.payload.integer));
+				}
+			}
+		},
+		v
+	);
+
+	return ret;
+}
+
+style_value style_value_pool::decode(const compact_style_value& v) const
+{
+	switch (v.type) {
+		case index_of<style_value_special>():
+			return style_value_special(v.payload.integer);
+		case index_of<uint32_t>():
+			return v.payload.integer;
+		case index_of<real>():
+			return v.payload.number;
+		case index_of<length>():
+			return length(v.payload.number, length_unit(v.unit));
+		case index_of<stroke_line_cap>():
+			return stroke_line_cap(v.payload.integer);
+		case index_of<stroke_line_join>():
+			return stroke_line_join(v.payload.integer);
+		case index_of<fill_rule>():
+			return fill_rule(v.payload.integer);
+		case index_of<color_interpolation>():
+			return color_interpolation(v.payload.integer);
+		case index_of<display>():
+			return display(v.payload.integer);
+		case index_of<enable_background_property>():
+			ASSERT(v.payload.integer < this->enable_backgrounds.size())
+			return this->enable_backgrounds[v.payload.integer];
+		case index_of<visibility>():
+			return visibility(v.payload.integer);
+		case index_of<std::string>():
+			return this->get_string(v);
+		case index_of<std::vector<length>>():
+			return this->get_dash_array(v);
+		default:
+			ASSERT(false)
+			return style_value_special::unknown;
+	}
+}
+
+const std::string& style_value_pool::get_string(const compact_style_value& v) const
+{
+	ASSERT(v.type == index_of<std::string>())
+	ASSERT(v.payload.integer < this->strings.size())
+	return this->strings[v.payload.integer];
+}
+
+const std::vector<length>& style_value_pool::get_dash_array(const compact_style_value& v) const
+{
+	ASSERT(v.type == index_of<std::vector<length>>())
+	ASSERT(v.payload.integer < this->dash_arrays.size())
+	return this->dash_arrays[v.payload.integer];
+}
+
+size_t style_value_pool::get_memory_size() const noexcept
+{
+	// hash table nodes are approximated by the key, the value and two pointers
+	constexpr size_t hash_node_overhead = sizeof(void*) * 2;
+
+	size_t ret = 0;
+	for (const auto& s : this->strings) {
+		ret += sizeof(s) + (s.capacity() > std::string().capacity() ? s.capacity() : 0);
+	}
+	ret += this->string_indices.size() * (sizeof(decltype(string_indices)::value_type) + hash_node_overhead);
+
+	for (const auto& d : this->dash_arrays) {
+		ret += sizeof(d) + d.capacity() * sizeof(length);
+	}
+	for (const auto& i : this->dash_array_indices) {
+		ret += sizeof(i) + hash_node_overhead + i.first.capacity();
+	}
+
+	ret += this->enable_backgrounds.capacity() * sizeof(enable_background_property);
+	for (const auto& i : this->enable_background_indices) {
+		ret += sizeof(i) + hash_node_overhead + i.first.capacity();
+	}
+
+	return ret;
+}
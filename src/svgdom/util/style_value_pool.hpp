@@ -0,0 +1,155 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015-2025 Ivan Gagis <igagis@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+/* ================ LICENSE END ================ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../elements/styleable.hpp"
+
+namespace svgdom {
+
+class style_value_pool;
+
+/**
+ * @brief Compact encoding of style_value.
+ * The value takes 8 bytes and never owns heap memory, so it is cheap to copy.
+ * Alternatives of style_value which do not fit into 8 bytes, i.e. strings, dash arrays and
+ * enable-background values, are stored in a style_value_pool and the compact value refers to them by index.
+ * Equal strings, dash arrays and enable-background values are stored in the pool only once, so two compact values
+ * encoded by the same pool are equal if and only if the style values they encode are equal.
+ * The only exception is that the real numbers within dash arrays and enable-background values are compared bitwise,
+ * so, for example, the values which differ only in the sign of a zero get different encodings.
+ */
+class compact_style_value
+{
+	friend class style_value_pool;
+
+	// index of the style_value alternative
+	uint8_t type = 0;
+
+	// unit of the length alternative
+	uint8_t unit = 0;
+
+	union {
+		// enumeration values, color, index in the pool
+		uint32_t integer;
+
+		// number and length value
+		real number;
+	} payload = {0};
+
+public:
+	/**
+	 * @brief Get index of the encoded style_value alternative.
+	 * @return index of the alternative, same as style_value::index() of the encoded value.
+	 */
+	size_t index() const noexcept
+	{
+		return this->type;
+	}
+
+	/**
+	 * @brief Compare compact values.
+	 * Numbers and lengths are compared as real numbers, the rest of the alternatives are compared
+	 * by their enumeration value, color or index in the pool.
+	 * @param v - compact value to compare with.
+	 * @return true if the values are equal.
+	 */
+	bool operator==(const compact_style_value& v) const noexcept;
+
+	bool operator!=(const compact_style_value& v) const noexcept
+	{
+		return !this->operator==(v);
+	}
+};
+
+static_assert(sizeof(compact_style_value) == 8, "compact_style_value is expected to be 8 bytes");
+
+/**
+ * @brief Pool of style values which do not fit into compact_style_value.
+ * Usually, there is one pool per document. The compact values are valid only with the pool which encoded them.
+ */
+class style_value_pool
+{
+	std::deque<std::string> strings;
+	std::unordered_map<std::string_view, uint32_t> string_indices;
+
+	std::vector<std::vector<length>> dash_arrays;
+
+	// dash arrays are compared bitwise, the key is the raw bytes of the lengths
+	std::unordered_map<std::string, uint32_t> dash_array_indices;
+
+	std::vector<enable_background_property> enable_backgrounds;
+
+	// enable-background values are compared bitwise, the key is the raw bytes of the value
+	std::unordered_map<std::string, uint32_t> enable_background_indices;
+
+public:
+	/**
+	 * @brief Encode style value.
+	 * Stores the value in the pool if needed.
+	 * @param v - style value to encode.
+	 * @return compact encoding of the value.
+	 */
+	compact_style_value encode(const style_value& v);
+
+	/**
+	 * @brief Decode style value.
+	 * @param v - compact value encoded by this pool.
+	 * @return decoded style value.
+	 */
+	style_value decode(const compact_style_value& v) const;
+
+	/**
+	 * @brief Get string without decoding the value.
+	 * @param v - compact value of the string alternative, encoded by this pool.
+	 * @return string referred by the value.
+	 */
+	const std::string& get_string(const compact_style_value& v) const;
+
+	/**
+	 * @brief Get dash array without decoding the value.
+	 * @param v - compact value of the dash array alternative, encoded by this pool.
+	 * @return dash array referred by the value.
+	 */
+	const std::vector<length>& get_dash_array(const compact_style_value& v) const;
+
+	/**
+	 * @brief Get approximate heap memory used by the pool.
+	 * @return number of bytes.
+	 */
+	size_t get_memory_size() const noexcept;
+};
+
+} // namespace svgdom
@@ -0,0 +1,176 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <sstream>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/bake_css.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/computed_styles.hpp"
+#include "../../src/svgdom/util/style_stack.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace{
+const auto svg = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+	<style type="text/css">
+		rect { fill: red; stroke-width: 3 }
+		.cls_a { fill: green }
+		g .cls_b { stroke: blue }
+		#rect_3 { opacity: 0.5 }
+	</style>
+	<g id="g_1" class="cls_b" stroke="yellow">
+		<rect id="rect_1" class="cls_a"/>
+		<rect id="rect_2" class="cls_a cls_b" style="fill: cyan"/>
+		<rect id="rect_3" fill="inherit"/>
+		<style type="text/css">
+			.cls_c { stroke-opacity: 0.3 }
+		</style>
+	</g>
+	<circle class="cls_c" fill="black"/>
+</svg>)qwertyuiop"sv;
+
+class css_collector : public svgdom::const_visitor{
+public:
+	std::vector<std::reference_wrapper<const cssom::sheet>> css;
+	size_t num_style_elements = 0;
+
+	void visit(const svgdom::style_element& e)override{
+		this->css.emplace_back(e.css);
+		++this->num_style_elements;
+	}
+};
+
+// computed style values of all elements of the document, as strings
+std::vector<std::string> get_computed_styles(const svgdom::svg_element& dom){
+	css_collector cc;
+	dom.accept(cc);
+
+	svgdom::computed_styles cs(dom, utki::make_span(cc.css));
+
+	svgdom::node_table table(dom);
+
+	std::vector<std::string> ret;
+	for(const auto& n : table.get_nodes()){
+		if(n.kind == svgdom::element_kind::style){
+			// style elements are removed by baking
+			continue;
+		}
+		std::stringstream ss;
+		for(size_t i = 1; i != size_t(svgdom::style_property::enum_size); ++i){
+			auto p = svgdom::style_property(i);
+			auto v = cs.get(*n.element, p);
+			if(v){
+				ss << svgdom::styleable::property_to_string(p) << ":" << svgdom::styleable::style_value_to_string(p, *v) << ";";
+			}
+		}
+		ret.push_back(ss.str());
+	}
+	return ret;
+}
+}
+
+namespace{
+const tst::set set("bake_css", [](tst::suite& suite){
+	suite.add("computed_styles_stay_the_same", [](){
+		auto dom = svgdom::load(svg);
+		tst::check(dom, SL);
+
+		auto expected = get_computed_styles(*dom);
+
+		svgdom::bake_css(*dom, true);
+
+		css_collector cc;
+		dom->accept(cc);
+		tst::check_eq(cc.num_style_elements, size_t(0), SL);
+
+		auto actual = get_computed_styles(*dom);
+
+		tst::check_eq(actual.size(), expected.size(), SL);
+		for(size_t i = 0; i != actual.size(); ++i){
+			tst::check_eq(actual[i], expected[i], [&](auto&o){o << "element #" << i;}, SL);
+		}
+	});
+
+	suite.add("style_attribute_has_priority", [](){
+		auto dom = svgdom::load(svg);
+		tst::check(dom, SL);
+
+		svgdom::bake_css(*dom);
+
+		// style elements are kept by default
+		css_collector cc;
+		dom->accept(cc);
+		tst::check_eq(cc.num_style_elements, size_t(2), SL);
+
+		auto g = dynamic_cast<const svgdom::g_element*>(dom->children[1].get());
+		tst::check(g, SL);
+		auto rect_2 = dynamic_cast<const svgdom::rect_element*>(g->children[1].get());
+		tst::check(rect_2, SL);
+		tst::check_eq(rect_2->id, std::string("rect_2"), SL);
+
+		auto fill = rect_2->get_style_property(svgdom::style_property::fill);
+		tst::check(fill, SL);
+		auto cyan = svgdom::parse_paint("cyan");
+		tst::check_eq(*std::get_if<uint32_t>(fill), *std::get_if<uint32_t>(&cyan), SL);
+	});
+
+	suite.add("important_css_does_not_override_style_attribute", [](){
+		auto dom = svgdom::load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+	<style type="text/css">
+		.a { fill: red !important }
+	</style>
+	<rect class="a" style="fill:blue"/>
+</svg>)qwertyuiop"sv);
+		tst::check(dom, SL);
+		tst::check_eq(dom->children.size(), size_t(2), SL);
+
+		auto style = dynamic_cast<const svgdom::style_element*>(dom->children[0].get());
+		tst::check(style, SL);
+		auto rect = dynamic_cast<const svgdom::rect_element*>(dom->children[1].get());
+		tst::check(rect, SL);
+
+		std::string expected;
+		{
+			svgdom::style_stack ss;
+			ss.add_css(*style);
+			svgdom::style_stack::push svg_push(ss, *dom);
+			svgdom::style_stack::push rect_push(ss, *rect);
+
+			auto fill = ss.get_style_property(svgdom::style_property::fill);
+			tst::check(fill, SL);
+			expected = svgdom::styleable::style_value_to_string(svgdom::style_property::fill, *fill);
+		}
+		tst::check_eq(expected, "blue"s, SL);
+
+		svgdom::bake_css(*dom);
+
+		auto fill = rect->get_style_property(svgdom::style_property::fill);
+		tst::check(fill, SL);
+		tst::check_eq(svgdom::styleable::style_value_to_string(svgdom::style_property::fill, *fill), expected, SL);
+	});
+
+	suite.add<std::string_view>(
+		"samples",
+		{
+			"samples_data/defs_style_2.svg"sv,
+			"samples_data/simple_css.svg"sv,
+			"samples_data/tiger.svg"sv
+		},
+		[](const auto& p){
+			auto dom = svgdom::load(fsif::native_file(p));
+			tst::check(dom, SL);
+
+			auto expected = get_computed_styles(*dom);
+
+			svgdom::bake_css(*dom, true);
+
+			tst::check(get_computed_styles(*dom) == expected, SL);
+		}
+	);
+});
+}
@@ -0,0 +1,201 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/computed_styles.hpp"
+#include "../../src/svgdom/util/style_stack.hpp"
+
+using namespace std::string_view_literals;
+
+namespace{
+class css_collector : public svgdom::const_visitor{
+public:
+	std::vector<std::reference_wrapper<const cssom::sheet>> css;
+	std::vector<std::reference_wrapper<const svgdom::style_element>> style_elements;
+
+	void visit(const svgdom::style_element& e)override{
+		this->css.emplace_back(e.css);
+		this->style_elements.emplace_back(e);
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		this->relay_accept(c);
+	}
+};
+
+// compares computed styles of each element to the ones given by style_stack
+class compare_visitor : public svgdom::const_visitor{
+	const svgdom::computed_styles& cs;
+	svgdom::style_stack ss;
+
+	void check(const svgdom::element& e){
+		++this->num_checked;
+		
+		if(!svgdom::cast_to_styleable(&e)){
+			for(size_t i = 0; i != size_t(svgdom::style_property::enum_size); ++i){
+				tst::check(!this->cs.get(e, svgdom::style_property(i)), SL);
+			}
+			return;
+		}
+
+		for(size_t i = 1; i != size_t(svgdom::style_property::enum_size); ++i){
+			auto p = svgdom::style_property(i);
+			tst::check(
+					this->cs.get(e, p) == this->ss.get_style_property(p),
+					[&](auto&o){o << "property " << svgdom::styleable::property_to_string(p) << " mismatch for element with id = " << e.id;},
+					SL
+				);
+		}
+	}
+
+public:
+	size_t num_checked = 0;
+
+	compare_visitor(const svgdom::computed_styles& cs, utki::span<const std::reference_wrapper<const cssom::sheet>> css) :
+			cs(cs)
+	{
+		for(const auto& s : css){
+			this->ss.add_css(s);
+		}
+	}
+
+	void default_visit(const svgdom::element& e)override{
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			this->check(e);
+			return;
+		}
+		svgdom::style_stack::push ss_push(this->ss, *s);
+		this->check(e);
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			this->check(e);
+			this->relay_accept(c);
+			return;
+		}
+		svgdom::style_stack::push ss_push(this->ss, *s);
+		this->check(e);
+		this->relay_accept(c);
+	}
+};
+
+void check_same_as_style_stack(const svgdom::svg_element& dom){
+	css_collector cc;
+	dom.accept(cc);
+
+	svgdom::computed_styles cs(dom, utki::make_span(cc.css));
+
+	compare_visitor v(cs, utki::make_span(cc.css));
+	dom.accept(v);
+
+	tst::check_eq(v.num_checked, cs.size(), SL);
+
+	// style elements' indices give the same values
+	svgdom::computed_styles indexed(dom, utki::make_span(cc.style_elements));
+	tst::check_eq(indexed.size(), cs.size(), SL);
+	for(size_t h = 0; h != cs.size(); ++h){
+		for(size_t i = 0; i != size_t(svgdom::style_property::enum_size); ++i){
+			auto p = svgdom::style_property(i);
+			tst::check(indexed.get(svgdom::node_table::handle(h), p) == cs.get(svgdom::node_table::handle(h), p), SL);
+		}
+	}
+}
+}
+
+namespace{
+const tst::set set("computed_styles", [](tst::suite& suite){
+	suite.add("cascade_and_inheritance", [](){
+		auto dom = svgdom::load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" id="root" fill="red" opacity="0.5">
+	<g id="g1" stroke="blue" style="fill:green">
+		<rect id="r1" fill="inherit" stroke="inherit"/>
+		<g id="g2" style="fill:inherit;opacity:inherit">
+			<circle id="c1" opacity="inherit"/>
+			<circle id="c2" style="stroke:yellow"/>
+		</g>
+	</g>
+	<linearGradient id="lg"><stop style="stop-color:red"/></linearGradient>
+</svg>)qwertyuiop"sv);
+		tst::check(dom, SL);
+
+		svgdom::computed_styles cs(*dom);
+
+		svgdom::node_table table(*dom);
+		tst::check_eq(cs.size(), table.size(), SL);
+
+		auto get = [&](std::string_view id, svgdom::style_property p) -> const svgdom::style_value* {
+			for(size_t i = 0; i != table.size(); ++i){
+				if(table[svgdom::node_table::handle(i)].element->id == id){
+					auto ret = cs.get(svgdom::node_table::handle(i), p);
+					tst::check(ret == cs.get(*table[svgdom::node_table::handle(i)].element, p), SL);
+					return ret;
+				}
+			}
+			tst::check(false, [&](auto&o){o << "element with id = " << id << " not found";}, SL);
+			return nullptr;
+		};
+
+		auto root_fill = get("root", svgdom::style_property::fill);
+		auto root_opacity = get("root", svgdom::style_property::opacity);
+		auto g1_fill = get("g1", svgdom::style_property::fill);
+		auto g1_stroke = get("g1", svgdom::style_property::stroke);
+		tst::check(root_fill, SL);
+		tst::check(root_opacity, SL);
+		tst::check(g1_fill, SL);
+		tst::check(g1_stroke, SL);
+		tst::check(g1_fill != root_fill, SL);
+
+		// opacity is not inheritable
+		tst::check(!get("g1", svgdom::style_property::opacity), SL);
+
+		tst::check(get("r1", svgdom::style_property::fill) == g1_fill, SL);
+		tst::check(get("r1", svgdom::style_property::stroke) == g1_stroke, SL);
+		tst::check(get("g2", svgdom::style_property::fill) == g1_fill, SL);
+
+		// explicit 'inherit' of not inheritable property takes the nearest ancestor's value
+		tst::check(get("g2", svgdom::style_property::opacity) == root_opacity, SL);
+		tst::check(get("c1", svgdom::style_property::opacity) == root_opacity, SL);
+
+		tst::check(get("c2", svgdom::style_property::stroke) != g1_stroke, SL);
+		tst::check(get("c2", svgdom::style_property::stroke), SL);
+		tst::check(get("c1", svgdom::style_property::stroke) == g1_stroke, SL);
+		tst::check(!get("c2", svgdom::style_property::opacity), SL);
+
+		// gradient stop has no id, get it as first child of the gradient
+		auto lg = table.find(*dom->children[1]);
+		tst::check(table[lg].kind == svgdom::element_kind::linear_gradient, SL);
+		tst::check(cs.get(table[lg].first_child, svgdom::style_property::stop_color), SL);
+		tst::check(!get("lg", svgdom::style_property::stop_color), SL);
+
+		svgdom::g_element not_in_document;
+		tst::check(!cs.get(not_in_document, svgdom::style_property::fill), SL);
+		tst::check(!cs.get(svgdom::node_table::handle(table.size()), svgdom::style_property::fill), SL);
+
+		check_same_as_style_stack(*dom);
+	});
+
+	suite.add<std::string_view>(
+		"same_as_style_stack",
+		{
+			"samples_data/camera.svg"sv,
+			"samples_data/car.svg"sv,
+			"samples_data/defs_style_2.svg"sv,
+			"samples_data/finders.svg"sv,
+			"samples_data/masking.svg"sv,
+			"samples_data/tiger.svg"sv
+		},
+		[](const auto& p){
+			auto dom = svgdom::load(fsif::native_file(p));
+			tst::check(dom, SL);
+
+			check_same_as_style_stack(*dom);
+		}
+	);
+});
+}
@@ -0,0 +1,238 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <thread>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/css_index.hpp"
+#include "../../src/svgdom/elements/style.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace{
+class crawler : public cssom::xml_dom_crawler{
+	const std::vector<const svgdom::styleable*>& stack;
+	size_t pos;
+public:
+	crawler(const std::vector<const svgdom::styleable*>& stack) :
+			stack(stack),
+			pos(stack.size() - 1)
+	{}
+
+	const cssom::styleable& get()override{
+		return *this->stack[this->pos];
+	}
+
+	bool move_up()override{
+		if(this->pos == 0){
+			return false;
+		}
+		--this->pos;
+		return true;
+	}
+
+	bool move_left()override{
+		return false;
+	}
+
+	void reset()override{
+		this->pos = this->stack.size() - 1;
+	}
+};
+
+// queries each property of each element from the sheet and from its index and compares the results
+class compare_visitor : public svgdom::const_visitor{
+	const cssom::sheet& sheet;
+	std::shared_ptr<const svgdom::css_index> index;
+
+	std::vector<const svgdom::styleable*> stack;
+
+	void check(){
+		crawler c(this->stack);
+		auto declarations = svgdom::match_css(utki::make_span(&this->index, 1), c);
+		for(uint32_t p = 0; p != uint32_t(svgdom::style_property::enum_size); ++p){
+			auto expected = this->sheet.get_property_value(c, p);
+			auto actual = this->index->get_property_value(c, p);
+			tst::check(actual.value == expected.value, SL);
+
+			// all properties matched at once give the same values
+			auto matched = declarations.get(svgdom::style_property(p));
+			if(expected.value){
+				tst::check_eq(actual.specificity, expected.specificity, SL);
+				tst::check(matched == &static_cast<const svgdom::style_element::css_style_value*>(expected.value)->value, SL);
+				++this->num_found;
+			}else{
+				tst::check(!matched, SL);
+			}
+		}
+	}
+
+public:
+	size_t num_found = 0;
+
+	compare_visitor(const cssom::sheet& sheet, std::shared_ptr<const svgdom::css_index> index) :
+			sheet(sheet),
+			index(std::move(index))
+	{}
+
+	void default_visit(const svgdom::element& e)override{
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			return;
+		}
+		this->stack.push_back(s);
+		this->check();
+		this->stack.pop_back();
+	}
+
+	void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+		auto s = svgdom::cast_to_styleable(&e);
+		if(!s){
+			this->relay_accept(c);
+			return;
+		}
+		this->stack.push_back(s);
+		this->check();
+		this->relay_accept(c);
+		this->stack.pop_back();
+	}
+};
+}
+
+namespace{
+const tst::set set("css_index", [](tst::suite& suite){
+	suite.add("same_as_sheet", [](){
+		auto dom = svgdom::load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+	<style type="text/css">
+		* { stroke-width: 2 }
+		rect { fill: red }
+		.cls_a { fill: green }
+		g .cls_a { stroke: blue }
+		.cls_a.cls_b { opacity: 0.5 }
+		#rect_2 { fill: yellow }
+		g#g_1 > rect.cls_b { stroke: cyan }
+		circle, .cls_b { fill-opacity: 0.3 }
+	</style>
+	<g id="g_1" class="cls_b">
+		<rect id="rect_1" class="cls_a"/>
+		<rect id="rect_2" class="cls_a cls_b"/>
+		<circle id="circle_1"/>
+		<g>
+			<rect class="cls_b"/>
+		</g>
+	</g>
+	<rect class="cls_a"/>
+	<path/>
+</svg>)qwertyuiop"sv);
+		tst::check(dom, SL);
+
+		auto style = dynamic_cast<const svgdom::style_element*>(dom->children.front().get());
+		tst::check(style, SL);
+
+		compare_visitor v(style->css, std::make_shared<svgdom::css_index>(style->css));
+		dom->accept(v);
+
+		tst::check(v.num_found != 0, SL);
+	});
+
+	suite.add("match_css_picks_winners_of_all_sheets", [](){
+		auto dom = svgdom::load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+	<style type="text/css">
+		rect { fill: red }
+		rect { stroke: red }
+		.cls_a { opacity: 0.5 }
+	</style>
+	<style type="text/css">
+		rect { fill: blue; stroke: blue }
+		#rect_1 { opacity: 0.7 }
+		* { stroke-width: 3 }
+	</style>
+	<rect id="rect_1" class="cls_a"/>
+</svg>)qwertyuiop"sv);
+		tst::check(dom, SL);
+		tst::check_eq(dom->children.size(), size_t(3), SL);
+
+		std::vector<std::shared_ptr<const svgdom::css_index>> css;
+		for(size_t i = 0; i != 2; ++i){
+			auto style = dynamic_cast<const svgdom::style_element*>(dom->children[i].get());
+			tst::check(style, SL);
+			css.push_back(style->get_css_index());
+		}
+
+		auto rect = svgdom::cast_to_styleable(dom->children[2].get());
+		tst::check(rect, SL);
+
+		std::vector<const svgdom::styleable*> stack = {dom.get(), rect};
+		crawler c(stack);
+
+		auto declarations = svgdom::match_css(utki::make_span(css), c);
+
+		auto to_string = [&](svgdom::style_property p){
+			auto v = declarations.get(p);
+			tst::check(v, [&](auto&o){o << "property = " << svgdom::styleable::property_to_string(p);}, SL);
+			return svgdom::styleable::style_value_to_string(p, *v);
+		};
+
+		// equal specificity, the earlier sheet wins
+		tst::check_eq(to_string(svgdom::style_property::fill), "red"s, SL);
+		tst::check_eq(to_string(svgdom::style_property::stroke), "red"s, SL);
+
+		// higher specificity of the later sheet wins
+		tst::check_eq(to_string(svgdom::style_property::opacity), "0.7"s, SL);
+
+		tst::check_eq(to_string(svgdom::style_property::stroke_width), "3"s, SL);
+		tst::check(!declarations.get(svgdom::style_property::fill_opacity), SL);
+		tst::check_eq(declarations.values.size(), size_t(4), SL);
+	});
+
+	suite.add("style_element_keeps_index", [](){
+		auto dom = svgdom::load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+	<style type="text/css">
+		rect { fill: red }
+		.cls_a { fill: green }
+	</style>
+	<rect class="cls_a"/>
+	<rect/>
+</svg>)qwertyuiop"sv);
+		tst::check(dom, SL);
+
+		auto style = dynamic_cast<svgdom::style_element*>(dom->children.front().get());
+		tst::check(style, SL);
+
+		std::vector<std::shared_ptr<const svgdom::css_index>> indices(4);
+		{
+			std::vector<std::thread> threads;
+			for(auto& i : indices){
+				threads.emplace_back([&i, style](){
+					i = style->get_css_index();
+				});
+			}
+			for(auto& t : threads){
+				t.join();
+			}
+		}
+
+		tst::check(indices.front(), SL);
+		for(const auto& i : indices){
+			tst::check(i == indices.front(), SL);
+		}
+		tst::check(style->get_css_index() == indices.front(), SL);
+
+		compare_visitor v(style->css, indices.front());
+		dom->accept(v);
+		tst::check(v.num_found != 0, SL);
+
+		style->invalidate_css_index();
+		auto rebuilt = style->get_css_index();
+		tst::check(rebuilt, SL);
+		tst::check(rebuilt != indices.front(), SL);
+		tst::check_eq(rebuilt->get_properties(), indices.front()->get_properties(), SL);
+		tst::check_eq(rebuilt->get_properties(), uint64_t(1) << size_t(svgdom::style_property::fill), SL);
+	});
+});
+}
@@ -8,6 +8,7 @@
 #include "../../src/svgdom/util/finder_by_class.hpp"
 #include "../../src/svgdom/util/finder_by_tag.hpp"
 #include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/atom_table.hpp"
 
 struct fixture{
 	std::unique_ptr<svgdom::svg_element> dom;
@@ -57,6 +58,54 @@ const tst::set set("finders", [](auto& suite){
 		tst::check(finder_by_class_name.find("non_existent_class").empty(), SL);
 	});
 
+	suite.add("finders_with_shared_atom_table", [](){
+		fixture f;
+
+		auto atoms = std::make_shared<svgdom::atom_table>();
+
+		svgdom::finder_by_id finder_by_id(*f.dom, atoms);
+		svgdom::finder_by_class finder_by_class_name(*f.dom, atoms);
+
+		tst::check(&finder_by_id.get_atoms() == atoms.get(), SL);
+		tst::check(&finder_by_class_name.get_atoms() == atoms.get(), SL);
+		tst::check_eq(atoms->size(), size_t(4), SL);
+
+		auto id1 = atoms->find("id1");
+		tst::check_ne(id1, svgdom::atom_table::npos, SL);
+		tst::check_eq(atoms->get(id1), std::string("id1"), SL);
+		tst::check(finder_by_id.find(id1) == finder_by_id.find("id1"), SL);
+		tst::check(finder_by_id.find(id1)->id == "id1", SL);
+
+		auto class2 = atoms->find("class2");
+		tst::check_ne(class2, svgdom::atom_table::npos, SL);
+		tst::check_eq(finder_by_class_name.find(class2).size(), size_t(1), SL);
+		tst::check(finder_by_class_name.find(class2).front()->id == "id2", SL);
+
+		// atoms of other kind of identifiers are not found
+		tst::check(finder_by_id.find(class2) == nullptr, SL);
+		tst::check(finder_by_class_name.find(id1).empty(), SL);
+		tst::check(finder_by_id.find(svgdom::atom_table::npos) == nullptr, SL);
+	});
+
+	suite.add("atom_table_interns_document_identifiers", [](){
+		auto dom = svgdom::load(std::string_view(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink">
+	<filter id="f"><feGaussianBlur in="SourceGraphic" result="blur"/></filter>
+	<use id="u" xlink:href="#f" class="a b"/>
+	<rect id="a" class="a"/>
+</svg>)qwertyuiop"));
+		tst::check(dom, SL);
+
+		svgdom::atom_table atoms(*dom);
+		for(const auto& id : {"f", "SourceGraphic", "blur", "u", "a", "b"}){
+			auto a = atoms.find(id);
+			tst::check(a != svgdom::atom_table::npos, [&](auto&o){o << "id = " << id;}, SL);
+			tst::check_eq(atoms.get(a), std::string(id), SL);
+			tst::check_eq(atoms.intern(id), a, SL);
+		}
+		tst::check_eq(atoms.size(), size_t(6), SL);
+		tst::check_eq(atoms.find("c"), svgdom::atom_table::npos, SL);
+	});
+
 	suite.add("finder_by_tag", [](){
 		fixture f;
 
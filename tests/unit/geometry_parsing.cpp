@@ -0,0 +1,108 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <svgdom/length.hpp>
+#include <svgdom/elements/shapes.hpp>
+#include <svgdom/elements/transformable.hpp>
+#include <svgdom/elements/view_boxed.hpp>
+
+namespace{
+// NOLINTNEXTLINE(cppcoreguidelines-interfaces-global-init)
+const tst::set set("geometry_parsing", [](tst::suite& suite){
+	suite.add("path_compact_notation", [](){
+		using step = svgdom::path_element::step;
+
+		auto path = svgdom::path_element::parse("M10-20.5.5 1e1L-.5e-1,2a1 1 0 01 10 10z");
+
+		tst::check_eq(path.size(), size_t(5), SL);
+
+		tst::check(path[0].type_v == step::type::move_abs, SL);
+		tst::check_eq(path[0].x, svgdom::real(10), SL);
+		tst::check_eq(path[0].y, svgdom::real(-20.5), SL);
+
+		// implicit lineto after moveto
+		tst::check(path[1].type_v == step::type::line_abs, SL);
+		tst::check_eq(path[1].x, svgdom::real(0.5), SL);
+		tst::check_eq(path[1].y, svgdom::real(10), SL);
+
+		tst::check(path[2].type_v == step::type::line_abs, SL);
+		tst::check_eq(path[2].x, svgdom::real(-0.05), SL);
+		tst::check_eq(path[2].y, svgdom::real(2), SL);
+
+		tst::check(path[3].type_v == step::type::arc_rel, SL);
+		tst::check(!path[3].flags.large_arc, SL);
+		tst::check(path[3].flags.sweep, SL);
+		tst::check_eq(path[3].x, svgdom::real(10), SL);
+		tst::check_eq(path[3].y, svgdom::real(10), SL);
+
+		tst::check(path[4].type_v == step::type::close, SL);
+	});
+
+	suite.add("path_malformed_tail_is_ignored", [](){
+		auto path = svgdom::path_element::parse("M 1 2 L 3 4 L 5 x 6");
+		tst::check_eq(path.size(), size_t(2), SL);
+
+		path = svgdom::path_element::parse("M 1 2 z 3 4");
+		tst::check_eq(path.size(), size_t(2), SL);
+	});
+
+	suite.add("points", [](){
+		auto points = svgdom::polyline_shape::parse(" 1,2 3 4,5.5e1 6 7");
+		tst::check_eq(points.size(), size_t(3), SL);
+		tst::check_eq(points[2][0], svgdom::real(5.5e1), SL);
+		tst::check_eq(points[2][1], svgdom::real(6), SL);
+	});
+
+	suite.add("transformations", [](){
+		using type = svgdom::transformable::transformation::type;
+
+		auto t = svgdom::transformable::parse("translate(10) scale(2) rotate(45 1,2), matrix(1 2 3 4 5 6) skewX(-1e1) bad(1)");
+		tst::check_eq(t.size(), size_t(5), SL);
+
+		tst::check(t[0].type_v == type::translate, SL);
+		tst::check_eq(t[0].x(), svgdom::real(10), SL);
+		tst::check_eq(t[0].y(), svgdom::real(0), SL);
+
+		tst::check(t[1].type_v == type::scale, SL);
+		tst::check_eq(t[1].y(), svgdom::real(2), SL);
+
+		tst::check(t[2].type_v == type::rotate, SL);
+		tst::check_eq(t[2].angle(), svgdom::real(45), SL);
+		tst::check_eq(t[2].y(), svgdom::real(2), SL);
+
+		tst::check(t[3].type_v == type::matrix, SL);
+		tst::check_eq(t[3].f, svgdom::real(6), SL);
+
+		tst::check(t[4].type_v == type::skewx, SL);
+		tst::check_eq(t[4].angle(), svgdom::real(-10), SL);
+	});
+
+	suite.add("length", [](){
+		auto l = svgdom::length::parse("-1.5e1mm");
+		tst::check_eq(l.value, svgdom::real(-15), SL);
+		tst::check(l.unit == svgdom::length_unit::mm, SL);
+
+		l = svgdom::length::parse("10");
+		tst::check_eq(l.value, svgdom::real(10), SL);
+		tst::check(l.unit == svgdom::length_unit::number, SL);
+	});
+
+	suite.add("length_malformed_is_unknown", [](){
+		for(auto str : {"", "px", "auto", "-"}){
+			auto l = svgdom::length::parse(str);
+			tst::check_eq(l.value, svgdom::real(0), [&](auto&o){o << "str = " << str;}, SL);
+			tst::check(l.unit == svgdom::length_unit::unknown, [&](auto&o){o << "str = " << str;}, SL);
+			tst::check(!l.is_valid(), SL);
+		}
+	});
+
+	suite.add("view_box", [](){
+		auto vb = svgdom::view_boxed::parse_view_box("0,0 100.5 1e2");
+		tst::check_eq(vb[2], svgdom::real(100.5), SL);
+		tst::check_eq(vb[3], svgdom::real(100), SL);
+
+		vb = svgdom::view_boxed::parse_view_box("0 0 100");
+		tst::check_eq(vb[0], svgdom::real(-1), SL);
+	});
+});
+}
@@ -1,14 +1,25 @@
 #include <tst/set.hpp>
 #include <tst/check.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
 
 #include <fsif/native_file.hpp>
 
 #include <svgdom/dom.hpp>
+#include <svgdom/malformed_svg_error.hpp>
 #include <svgdom/util/style_stack.hpp>
 #include <svgdom/util/finder_by_id.hpp>
 #include <svgdom/elements/style.hpp>
+#include <svgdom/visitor.hpp>
+#include <svgdom/pipelined_loader.hpp>
+
+#include "../../src/svgdom/thread_pool.hxx"
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -26,6 +37,25 @@ const tst::set set("misc", [](tst::suite& suite){
         }
     );
 
+    suite.add(
+        "read_from_istream_with_size_hint",
+        [](){
+            auto buf = fsif::native_file("samples_data/tiger.svg").load();
+            auto str = std::string(buf.begin(), buf.end());
+
+            auto expected = svgdom::load(std::string_view(str));
+            tst::check(expected, SL);
+
+            // exact, too small, too big and absurdly big hints
+            for(auto hint : {str.size(), size_t(1), str.size() * 2, std::numeric_limits<size_t>::max()}){
+                std::istringstream ist(str);
+                auto dom = svgdom::load(ist, hint);
+                tst::check(dom, SL);
+                tst::check_eq(dom->to_string(), expected->to_string(), SL);
+            }
+        }
+    );
+
     suite.add(
         "read_from_native_file",
         [](){
@@ -106,5 +136,754 @@ const tst::set set("misc", [](tst::suite& suite){
         tst::check(std::holds_alternative<uint32_t>(*fill), SL);
         tst::check_eq(std::get<uint32_t>(*fill), 0x6a5047U, SL);
     });
+
+    suite.add("keyword_lookups", [](){
+        for(auto name : {"lightgoldenrodyellow"sv, "mediumaquamarine"sv, "mediumspringgreen"sv, "aqua"sv, "yellowgreen"sv}){
+            auto c = svgdom::parse_paint(name);
+            tst::check(std::holds_alternative<uint32_t>(c), [&](auto&o){o << "name = " << name;}, SL);
+            tst::check_eq(svgdom::paint_to_string(c), std::string(name), SL);
+        }
+
+        tst::check(std::holds_alternative<svgdom::style_value_special>(svgdom::parse_paint("notacolor")), SL);
+
+        for(size_t i = size_t(svgdom::style_property::unknown) + 1; i != size_t(svgdom::style_property::enum_size); ++i){
+            auto p = svgdom::style_property(i);
+            auto name = svgdom::styleable::property_to_string(p);
+            tst::check(!name.empty(), [&](auto&o){o << "i = " << i;}, SL);
+            tst::check(svgdom::styleable::string_to_property(name) == p, [&](auto&o){o << "name = " << name;}, SL);
+        }
+
+        tst::check(svgdom::styleable::string_to_property("fill-opacity-") == svgdom::style_property::unknown, SL);
+
+        auto table_cell = "table-cell"sv;
+        tst::check_eq(svgdom::display_to_string(svgdom::parse_display(table_cell)), table_cell, SL);
+        tst::check_eq(svgdom::visibility_to_string(svgdom::parse_visibility("collapse")), "collapse"sv, SL);
+    });
+
+    suite.add("rgb_components_are_real_and_clamped", [](){
+        auto rgb = [](uint32_t r, uint32_t g, uint32_t b){
+            return r | (g << 8) | (b << 16);
+        };
+
+        auto c = svgdom::parse_paint("rgb(300, -5, 10.6)");
+        tst::check(std::holds_alternative<uint32_t>(c), SL);
+        tst::check_eq(std::get<uint32_t>(c), rgb(255, 0, 10), SL);
+
+        c = svgdom::parse_paint("rgb(150%, 50%, 0.5%)");
+        tst::check(std::holds_alternative<uint32_t>(c), SL);
+        tst::check_eq(std::get<uint32_t>(c), rgb(255, 127, 1), SL);
+
+        c = svgdom::parse_paint("rgb(-10%,1e2%,0%)");
+        tst::check(std::holds_alternative<uint32_t>(c), SL);
+        tst::check_eq(std::get<uint32_t>(c), rgb(0, 255, 0), SL);
+
+        // malformed rgb() is 'none'
+        for(auto str : {"rgb(1,2"sv, "rgb(1%,2,3)"sv, "rgb()"sv, "rgb(a,b,c)"sv}){
+            c = svgdom::parse_paint(str);
+            tst::check(
+                std::holds_alternative<svgdom::style_value_special>(c) &&
+                    std::get<svgdom::style_value_special>(c) == svgdom::style_value_special::none,
+                [&](auto&o){o << "str = " << str;},
+                SL
+            );
+        }
+    });
+
+    suite.add("try_load_reports_error_with_line", [](){
+        auto str = R"qwertyuiop(<?xml version="1.0" encoding="utf-8"?>
+<svg width="1000px" height="1000px" xmlns="http://www.w3.org/2000/svg">
+    <rect width="100%" height="100%"/>
+    <rect x="93" y="98.5" width="814" height="803"/>
+)qwertyuiop"sv;
+
+        auto res = svgdom::try_load(str);
+        tst::check(!res, SL);
+        tst::check(!res.dom, SL);
+        tst::check(!res.error.empty(), SL);
+
+        // the position is not reported unless requested
+        tst::check_eq(res.line, size_t(0), SL);
+        tst::check_eq(res.column, size_t(0), SL);
+
+        svgdom::load_options options;
+        options.locate_errors = true;
+
+        auto located = svgdom::try_load(str, options);
+        tst::check(!located, SL);
+        tst::check_eq(located.error, res.error, SL);
+        tst::check_eq(located.line, size_t(5), SL);
+        tst::check_eq(located.column, size_t(1), SL);
+    });
+
+    suite.add("try_load_reports_error_column_in_single_line_document", [](){
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><rect width="10"/><rect x/></svg>)qwertyuiop"sv;
+
+        svgdom::load_options options;
+        options.locate_errors = true;
+
+        auto res = svgdom::try_load(str, options);
+        tst::check(!res, SL);
+        tst::check_eq(res.line, size_t(1), SL);
+
+        // the error is somewhere within the malformed element
+        auto malformed_begin = str.find("<rect x");
+        auto malformed_end = str.find("</svg>");
+        tst::check(
+            res.column > malformed_begin && res.column <= malformed_end,
+            [&](auto&o){o << "column = " << res.column;},
+            SL
+        );
+    });
+
+    suite.add("try_load_reports_non_svg_root", [](){
+        auto str = R"qwertyuiop(<?xml version="1.0" encoding="utf-8"?>
+<g xmlns="http://www.w3.org/2000/svg">
+    <rect width="100%" height="100%"/>
+</g>
+)qwertyuiop"sv;
+
+        svgdom::load_options options;
+        options.locate_errors = true;
+
+        auto res = svgdom::try_load(str, options);
+        tst::check(!res, SL);
+        tst::check_eq(res.line, size_t(2), SL);
+        tst::check(res.column != 0, SL);
+
+        bool thrown = false;
+        try{
+            svgdom::load(str);
+        }catch(svgdom::malformed_svg_error&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+
+    suite.add("malformed_attribute_values_are_ignored", [](){
+        auto str = R"qwertyuiop(<svg width="auto" xmlns="http://www.w3.org/2000/svg">
+    <rect x="1" y="abc" width="10" height="10" opacity="none" stroke-miterlimit="x" fill="rgb(1,2" stroke="hsl(1,2%" transform="translate(" enable-background="new 1 2"/>
+</svg>
+)qwertyuiop"sv;
+
+        auto res = svgdom::try_load(str);
+        tst::check(res, [&](auto&o){o << "error = " << res.error;}, SL);
+        tst::check(res.error.empty(), SL);
+        tst::check_eq(res.line, size_t(0), SL);
+        tst::check_eq(res.dom->children.size(), size_t(1), SL);
+    });
+
+    suite.add("namespace_scopes", [](){
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" xmlns:x="http://www.w3.org/1999/xlink">
+    <g xmlns="http://example.com/not-svg"><rect/></g>
+    <g><use x:href="#a"/></g>
+    <s:g xmlns:s="http://www.w3.org/2000/svg"><s:rect/></s:g>
+    <s:g/>
+    <rect/>
+</svg>
+)qwertyuiop"sv;
+
+        auto dom = svgdom::load(str);
+        tst::check(dom, SL);
+
+        // the first 'g' is not in svg namespace, and 's' prefix is not declared for the second 's:g'
+        tst::check_eq(dom->children.size(), size_t(3), SL);
+
+        auto g = dynamic_cast<const svgdom::g_element*>(dom->children[0].get());
+        tst::check(g, SL);
+        tst::check_eq(g->children.size(), size_t(1), SL);
+        auto use = dynamic_cast<const svgdom::use_element*>(g->children[0].get());
+        tst::check(use, SL);
+        tst::check_eq(use->iri, "#a"s, SL);
+
+        auto sg = dynamic_cast<const svgdom::g_element*>(dom->children[1].get());
+        tst::check(sg, SL);
+        tst::check_eq(sg->children.size(), size_t(1), SL);
+    });
+
+    suite.add("stream_visits_elements_when_closed", [](){
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+    <g id="g1">
+        <rect id="r1"/>
+        <unknown><rect id="r2"/></unknown>
+        <circle id="c1"/>
+    </g>
+    <style>rect{fill:red}</style>
+</svg>
+)qwertyuiop"sv;
+
+        class recorder : public svgdom::visitor{
+        public:
+            std::vector<std::string> ids;
+            std::vector<size_t> num_children;
+            size_t num_styles = 0;
+
+            void visit(svgdom::style_element& e)override{
+                this->num_styles = e.css.styles.size();
+                this->default_visit(e);
+            }
+
+            void default_visit(svgdom::element& e)override{
+                this->ids.push_back(e.id);
+                this->num_children.push_back(0);
+            }
+
+            void default_visit(svgdom::element& e, svgdom::container& c)override{
+                this->ids.push_back(e.id);
+                this->num_children.push_back(c.children.size());
+            }
+        } r;
+
+        svgdom::stream(str, r);
+
+        // children are visited before their parents, containers are visited without children,
+        // elements inside unknown elements are not visited, same as they are not added to the DOM
+        tst::check_eq(r.ids, std::vector<std::string>{"r1", "c1", "g1", "", ""}, SL);
+        tst::check_eq(r.num_children, std::vector<size_t>{0, 0, 0, 0, 0}, SL);
+        tst::check_eq(r.num_styles, size_t(1), SL);
+    });
+
+    suite.add("stream_and_load_visit_same_elements", [](){
+        class counter : public svgdom::visitor{
+        public:
+            size_t count = 0;
+
+            void default_visit(svgdom::element& e)override{
+                ++this->count;
+            }
+
+            void default_visit(svgdom::element& e, svgdom::container& c)override{
+                ++this->count;
+                this->relay_accept(c);
+            }
+        };
+
+        auto buf = fsif::native_file("samples_data/tiger.svg").load();
+
+        counter loaded;
+        svgdom::load(utki::make_span(buf))->accept(loaded);
+
+        counter streamed;
+        svgdom::stream(utki::make_span(buf), streamed);
+
+        tst::check_ne(streamed.count, size_t(0), SL);
+        tst::check_eq(streamed.count, loaded.count, SL);
+    });
+
+    suite.add("stream_throws_on_malformed_document", [](){
+        svgdom::visitor v;
+
+        bool thrown = false;
+        try{
+            svgdom::stream(R"qwertyuiop(<g xmlns="http://www.w3.org/2000/svg"/>)qwertyuiop"sv, v);
+        }catch(svgdom::malformed_svg_error&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+    });
+
+    suite.add("selective_loading_skips_element_kinds", [](){
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+    <filter id="f"><feGaussianBlur stdDeviation="2"/></filter>
+    <g id="g1">
+        <rect id="r1"/>
+        <text id="t1">hello</text>
+    </g>
+    <image id="i1" href="data:image/png;base64,AAAA"/>
+</svg>
+)qwertyuiop"sv;
+
+        svgdom::load_options options;
+        options.skip(svgdom::element_kind::filter).skip(svgdom::element_kind::text).skip(svgdom::element_kind::image);
+
+        auto res = svgdom::try_load(str, options);
+        tst::check(res, [&](auto&o){o << "error = " << res.error;}, SL);
+
+        tst::check_eq(res.dom->children.size(), size_t(1), SL);
+        auto g = dynamic_cast<const svgdom::g_element*>(res.dom->children[0].get());
+        tst::check(g, SL);
+        tst::check_eq(g->children.size(), size_t(1), SL);
+        tst::check_eq(g->children[0]->id, "r1"s, SL);
+
+        tst::check_ne(res.stats.skipped_bytes, size_t(0), SL);
+        tst::check_ne(res.stats.parsed_bytes, size_t(0), SL);
+
+        auto full = svgdom::try_load(str, svgdom::load_options());
+        tst::check(full, SL);
+        tst::check_eq(full.stats.skipped_bytes, size_t(0), SL);
+        tst::check_eq(
+            full.stats.parsed_bytes,
+            res.stats.parsed_bytes + res.stats.skipped_bytes,
+            SL
+        );
+    });
+
+    suite.add("selective_loading_by_id", [](){
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+    <g id="keep"><rect id="inner"/></g>
+    <g id="drop"><rect id="keep"/></g>
+    <rect/>
+</svg>
+)qwertyuiop"sv;
+
+        svgdom::load_options options;
+        options.ids = {"keep", "inner"};
+
+        auto dom = svgdom::load(str, options);
+        tst::check(dom, SL);
+
+        // element without id is not affected, subtree of the skipped element is skipped entirely
+        tst::check_eq(dom->children.size(), size_t(2), SL);
+        tst::check_eq(dom->children[0]->id, "keep"s, SL);
+        tst::check_eq(dom->children[1]->id, ""s, SL);
+
+        auto g = dynamic_cast<const svgdom::g_element*>(dom->children[0].get());
+        tst::check(g, SL);
+        tst::check_eq(g->children.size(), size_t(1), SL);
+    });
+
+    suite.add("selective_loading_reports_unclosed_skipped_element", [](){
+        svgdom::load_options options;
+        options.skip(svgdom::element_kind::g);
+
+        auto res = svgdom::try_load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><g><rect/></svg>)qwertyuiop"sv, options);
+        tst::check(!res, SL);
+    });
+
+    suite.add("parallel_decoding_gives_same_document", [](){
+        auto buf = fsif::native_file("samples_data/tiger.svg").load();
+        auto str = std::string_view(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+        auto expected = svgdom::load(str)->to_string();
+
+        for(unsigned num_threads : {0, 2, 3, 8}){
+            svgdom::load_options options;
+            options.num_threads = num_threads;
+
+            auto dom = svgdom::load(str, options);
+            tst::check(dom, SL);
+
+            tst::check_eq(dom->to_string(), expected, [&](auto&o){o << "num_threads = " << num_threads;}, SL);
+        }
+    });
+
+    suite.add("style_map_behaves_like_std_map", [](){
+        svgdom::style_map m;
+        tst::check(m.empty(), SL);
+
+        tst::check(m.emplace(svgdom::style_property::stroke, svgdom::make_style_value(0, 0, 0xff)).second, SL);
+        tst::check(m.insert({svgdom::style_property::fill, svgdom::make_style_value(0xff, 0, 0)}).second, SL);
+        m[svgdom::style_property::writing_mode] = std::string("lr");
+        m[svgdom::style_property::font] = std::string("serif");
+
+        // existing entry is not replaced by emplace
+        tst::check(!m.emplace(svgdom::style_property::fill, svgdom::style_value_special::none).second, SL);
+        tst::check(!svgdom::is_none(m.at(svgdom::style_property::fill)), SL);
+
+        tst::check(!m.insert_or_assign(svgdom::style_property::fill, svgdom::style_value_special::none).second, SL);
+        tst::check(svgdom::is_none(m.at(svgdom::style_property::fill)), SL);
+
+        // entries are in the order of the properties
+        std::vector<svgdom::style_property> keys;
+        for(const auto& e : m){
+            keys.push_back(e.first);
+        }
+        tst::check(keys == std::vector<svgdom::style_property>{
+                svgdom::style_property::font,
+                svgdom::style_property::fill,
+                svgdom::style_property::stroke,
+                svgdom::style_property::writing_mode
+            }, SL);
+
+        tst::check_eq(m.size(), size_t(4), SL);
+        tst::check_eq(m.count(svgdom::style_property::stroke), size_t(1), SL);
+        tst::check(m.find(svgdom::style_property::opacity) == m.end(), SL);
+
+        tst::check_eq(m.erase(svgdom::style_property::fill), size_t(1), SL);
+        tst::check_eq(m.erase(svgdom::style_property::fill), size_t(0), SL);
+        tst::check(m.find(svgdom::style_property::fill) == m.end(), SL);
+        tst::check(m.find(svgdom::style_property::stroke)->first == svgdom::style_property::stroke, SL);
+        tst::check_eq(std::get<std::string>(m.at(svgdom::style_property::writing_mode)), "lr"s, SL);
+
+        bool thrown = false;
+        try{
+            m.at(svgdom::style_property::opacity);
+        }catch(std::out_of_range&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+
+        // maps are equal when they have same properties with same values
+        auto copy = m;
+        tst::check(copy == m, SL);
+        copy[svgdom::style_property::stroke_width] = svgdom::length(1, svgdom::length_unit::px);
+        tst::check(copy != m, SL);
+        copy.erase(svgdom::style_property::stroke_width);
+        tst::check(copy == m, SL);
+        copy.insert_or_assign(svgdom::style_property::writing_mode, std::string("rl"));
+        tst::check(copy != m, SL);
+
+        m.clear();
+        tst::check(m.empty(), SL);
+        tst::check(m.find(svgdom::style_property::stroke) == m.end(), SL);
+    });
+
+    suite.add("thread_pool_runs_each_task_once", [](){
+        constexpr size_t num_tasks = 10000;
+
+        svgdom::thread_pool pool(4);
+        tst::check_eq(pool.size(), size_t(4), SL);
+
+        for(unsigned batch = 0; batch != 3; ++batch){
+            std::vector<std::atomic<unsigned>> counters(num_tasks);
+
+            std::atomic<bool> worker_out_of_range = false;
+
+            pool.run(num_tasks, [&](size_t i, size_t worker){
+                ++counters[i];
+                if(worker >= pool.size()){
+                    worker_out_of_range = true;
+                }
+            });
+
+            for(const auto& c : counters){
+                tst::check_eq(c.load(), 1u, SL);
+            }
+            tst::check(!worker_out_of_range.load(), SL);
+        }
+
+        bool thrown = false;
+        std::atomic<size_t> num_executed = 0;
+        try{
+            pool.run(num_tasks, [&](size_t i, size_t){
+                ++num_executed;
+                if(i == num_tasks / 2){
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }catch(std::runtime_error&){
+            thrown = true;
+        }
+        tst::check(thrown, SL);
+        tst::check_eq(num_executed.load(), num_tasks, SL);
+    });
+
+    suite.add("thread_pool_limits_workers_and_serializes_batches", [](){
+        constexpr size_t num_tasks = 1000;
+
+        svgdom::thread_pool pool(4);
+
+        for(size_t num_workers : {1, 2, 4, 10}){
+            std::atomic<size_t> max_worker = 0;
+            std::atomic<size_t> num_executed = 0;
+
+            pool.run(
+                num_tasks,
+                [&](size_t, size_t worker){
+                    ++num_executed;
+                    for(auto m = max_worker.load(); m < worker && !max_worker.compare_exchange_weak(m, worker);){}
+                },
+                num_workers
+            );
+
+            tst::check_eq(num_executed.load(), num_tasks, SL);
+            tst::check(max_worker.load() < std::min(num_workers, pool.size()), [&](auto&o){o << "num_workers = " << num_workers;}, SL);
+        }
+
+        // batches run by different threads at the same time are executed one after another
+        std::atomic<unsigned> num_running = 0;
+        std::atomic<bool> overlapped = false;
+        std::atomic<size_t> num_executed = 0;
+
+        auto run_batch = [&](){
+            pool.run(num_tasks, [&](size_t i, size_t){
+                if(i == 0){
+                    if(++num_running != 1){
+                        overlapped = true;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    --num_running;
+                }
+                ++num_executed;
+            });
+        };
+
+        std::thread other(run_batch);
+        run_batch();
+        other.join();
+
+        tst::check_eq(num_executed.load(), num_tasks * 2, SL);
+        tst::check(!overlapped.load(), SL);
+    });
+
+    suite.add("image_data_url_is_decoded", [](){
+        auto d = svgdom::image_element::parse_data_url("data:image/png;base64,aGVs\nbG8h");
+        tst::check(d.has_value(), SL);
+        tst::check_eq(d->media_type, "image/png"s, SL);
+        tst::check_eq(std::string(d->data.begin(), d->data.end()), "hello!"s, SL);
+
+        // incomplete last quantum, with and without padding
+        for(auto str : {"data:;base64,aGk="sv, "data:;base64,aGk"sv}){
+            d = svgdom::image_element::parse_data_url(str);
+            tst::check(d.has_value(), SL);
+            tst::check(d->media_type.empty(), SL);
+            tst::check_eq(std::string(d->data.begin(), d->data.end()), "hi"s, SL);
+        }
+
+        // encoding pads incomplete last quantum
+        tst::check_eq(svgdom::image_element::data_url{"", {'h', 'i'}}.to_string(), "data:;base64,aGk="s, SL);
+        tst::check_eq(svgdom::image_element::data_url{"text/plain", {'h'}}.to_string(), "data:text/plain;base64,aA=="s, SL);
+
+        d = svgdom::image_element::parse_data_url("data:image/svg+xml;charset=utf8,%3Csvg%2F%3e");
+        tst::check(d.has_value(), SL);
+        tst::check_eq(d->media_type, "image/svg+xml;charset=utf8"s, SL);
+        tst::check_eq(std::string(d->data.begin(), d->data.end()), "<svg/>"s, SL);
+
+        for(auto str : {"image.png"sv, "data:image/png;base64"sv, "data:;base64,a"sv, "data:;base64,a*bc"sv, "data:,%2"sv, "data:,%zz"sv}){
+            tst::check(!svgdom::image_element::parse_data_url(str).has_value(), [&](auto&o){o << "str = " << str;}, SL);
+        }
+
+        auto doc = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink">
+    <image xlink:href="data:image/png;base64,aGVsbG8h" transform="scale(2)" style="opacity:0.5"/>
+    <image xlink:href="image.png"/>
+</svg>
+)qwertyuiop"sv;
+
+        // data URLs are not decoded by default
+        {
+            auto dom = svgdom::load(doc);
+            tst::check(dom, SL);
+            auto embedded = dynamic_cast<const svgdom::image_element*>(dom->children[0].get());
+            tst::check(embedded, SL);
+            tst::check(!embedded->data.has_value(), SL);
+            tst::check_eq(embedded->iri, "data:image/png;base64,aGVsbG8h"s, SL);
+        }
+
+        for(unsigned num_threads : {1, 0}){
+            svgdom::load_options options;
+            options.num_threads = num_threads;
+            options.decode_data_urls = true;
+
+            auto dom = svgdom::load(doc, options);
+            tst::check(dom, SL);
+            tst::check_eq(dom->children.size(), size_t(2), SL);
+
+            auto embedded = dynamic_cast<const svgdom::image_element*>(dom->children[0].get());
+            tst::check(embedded, SL);
+            tst::check(embedded->data.has_value(), [&](auto&o){o << "num_threads = " << num_threads;}, SL);
+            tst::check_eq(std::string(embedded->data->data.begin(), embedded->data->data.end()), "hello!"s, SL);
+            tst::check_eq(embedded->transformations.size(), size_t(1), SL);
+            tst::check(embedded->get_style_property(svgdom::style_property::opacity), SL);
+
+            // the decoded image is not kept twice
+            tst::check(embedded->iri.empty(), SL);
+
+            auto linked = dynamic_cast<const svgdom::image_element*>(dom->children[1].get());
+            tst::check(linked, SL);
+            tst::check(!linked->data.has_value(), SL);
+            tst::check_eq(linked->iri, "image.png"s, SL);
+
+            // the decoded image is written back as data URL
+            auto reloaded = svgdom::load(dom->to_string());
+            tst::check(reloaded, SL);
+            embedded = dynamic_cast<const svgdom::image_element*>(reloaded->children[0].get());
+            tst::check(embedded, SL);
+            tst::check_eq(embedded->iri, "data:image/png;base64,aGVsbG8h"s, SL);
+        }
+    });
+
+    suite.add("pipelined_loader_gives_same_document", [](){
+        auto buf = fsif::native_file("samples_data/tiger.svg").load();
+        auto str = std::string_view(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+        auto expected = svgdom::load(str)->to_string();
+
+        for(size_t chunk_size : {1, 7, 4096, 1000000}){
+            svgdom::pipelined_loader loader;
+            for(size_t pos = 0; pos < str.size(); pos += chunk_size){
+                loader.feed(str.substr(pos, chunk_size));
+            }
+            auto dom = loader.end();
+            tst::check(dom, SL);
+            tst::check_eq(dom->to_string(), expected, [&](auto&o){o << "chunk_size = " << chunk_size;}, SL);
+        }
+    });
+
+    suite.add("pipelined_loader_keeps_copy_of_options", [](){
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+    <rect id="a"/>
+    <rect id="b"/>
+    <g><rect/></g>
+</svg>
+)qwertyuiop"sv;
+
+        // the options object is destroyed right after the loader is constructed
+        svgdom::pipelined_loader loader([](){
+            svgdom::load_options options;
+            options.ids = {"b"s + std::string(100, 'x'), "a"s};
+            return options;
+        }());
+
+        loader.feed(str);
+        auto dom = loader.end();
+        tst::check(dom, SL);
+        tst::check_eq(dom->children.size(), size_t(2), SL);
+        tst::check_eq(dom->children[0]->id, "a"s, SL);
+    });
+
+    suite.add("pipelined_loader_reports_errors", [](){
+        {
+            svgdom::pipelined_loader loader;
+            loader.feed(R"qwertyuiop(<g xmlns="http://www.w3.org/2000/svg"/>)qwertyuiop"sv);
+
+            bool thrown = false;
+            try{
+                loader.end();
+            }catch(svgdom::malformed_svg_error&){
+                thrown = true;
+            }
+            tst::check(thrown, SL);
+        }
+        {
+            svgdom::pipelined_loader loader;
+            loader.feed(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><g>)qwertyuiop"sv);
+
+            bool thrown = false;
+            try{
+                loader.end();
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL);
+        }
+        {
+            // destroying the loader without calling end() stops the building thread
+            svgdom::pipelined_loader loader;
+            loader.feed(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><g>)qwertyuiop"sv);
+        }
+    });
+
+    suite.add("loader_reuse_gives_same_documents", [](){
+        auto buf = fsif::native_file("samples_data/tiger.svg").load();
+        auto tiger = std::string_view(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+        auto expected = svgdom::load(tiger)->to_string();
+
+        auto unclosed = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><g><rect/>)qwertyuiop"sv;
+        auto not_svg = R"qwertyuiop(<g xmlns="http://www.w3.org/2000/svg"/>)qwertyuiop"sv;
+
+        svgdom::loader loader;
+
+        for(unsigned i = 0; i != 3; ++i){
+            auto dom = loader.load(tiger);
+            tst::check(dom, SL);
+            tst::check_eq(dom->to_string(), expected, SL);
+
+            // failed load in the middle of the document does not affect the next load
+            bool thrown = false;
+            try{
+                loader.load(unclosed);
+            }catch(std::invalid_argument&){
+                thrown = true;
+            }
+            tst::check(thrown, SL);
+
+            auto res = loader.try_load(not_svg);
+            tst::check(!res, SL);
+            tst::check_eq(res.error, svgdom::try_load(not_svg).error, SL);
+        }
+
+        // loading options are kept between the loads
+        auto str = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg"><rect id="r"/><text id="t">hello</text></svg>)qwertyuiop"sv;
+
+        svgdom::load_options options;
+        options.skip(svgdom::element_kind::text);
+
+        svgdom::loader selective_loader(options);
+        for(unsigned i = 0; i != 2; ++i){
+            auto res = selective_loader.try_load(str);
+            tst::check(res, SL);
+            tst::check_eq(res.dom->children.size(), size_t(1), SL);
+            tst::check_eq(res.dom->children[0]->id, "r"s, SL);
+            tst::check_ne(res.stats.skipped_bytes, size_t(0), SL);
+        }
+    });
+
+    suite.add("load_batch_gives_per_input_results", [](){
+        auto buf = fsif::native_file("samples_data/tiger.svg").load();
+        auto tiger = std::string_view(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+        auto expected = svgdom::load(tiger)->to_string();
+
+        auto malformed = R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg">
+<g>
+<rect/
+</svg>)qwertyuiop"sv;
+        auto not_svg = R"qwertyuiop(<g xmlns="http://www.w3.org/2000/svg"/>)qwertyuiop"sv;
+
+        std::vector<utki::span<const char>> buffers;
+        for(unsigned i = 0; i != 10; ++i){
+            buffers.push_back(utki::make_span(tiger));
+            buffers.push_back(utki::make_span(malformed));
+            buffers.push_back(utki::make_span(not_svg));
+        }
+
+        for(unsigned num_threads : {1, 3}){
+            svgdom::load_options options;
+            options.num_threads = num_threads;
+            options.locate_errors = true;
+
+            auto results = svgdom::load_batch(utki::make_span(buffers), options);
+            tst::check_eq(results.size(), buffers.size(), SL);
+
+            for(size_t i = 0; i != results.size(); i += 3){
+                tst::check(results[i], SL);
+                tst::check_eq(results[i].dom->to_string(), expected, SL);
+
+                auto expected_error = svgdom::try_load(malformed, options);
+                tst::check(!results[i + 1], SL);
+                tst::check_eq(results[i + 1].error, expected_error.error, SL);
+                tst::check_ne(results[i + 1].line, size_t(0), SL);
+                tst::check_eq(results[i + 1].line, expected_error.line, SL);
+                tst::check_eq(results[i + 1].column, expected_error.column, SL);
+
+                tst::check(!results[i + 2], SL);
+                tst::check(!results[i + 2].error.empty(), SL);
+            }
+        }
+
+        {
+            fsif::native_file tiger_file("samples_data/tiger.svg");
+            fsif::native_file missing_file("samples_data/non_existing_file.svg");
+
+            std::vector<std::reference_wrapper<const fsif::file>> files = {tiger_file, missing_file};
+
+            auto results = svgdom::load_batch(utki::make_span(files));
+            tst::check_eq(results.size(), size_t(2), SL);
+            tst::check(results[0], SL);
+            tst::check_eq(results[0].dom->to_string(), expected, SL);
+            tst::check(!results[1], SL);
+            tst::check(!results[1].error.empty(), SL);
+
+            svgdom::loader loader;
+            auto r = loader.try_load(tiger_file);
+            tst::check(r, SL);
+            tst::check_eq(r.dom->to_string(), expected, SL);
+
+            r = loader.try_load(missing_file);
+            tst::check(!r, SL);
+            tst::check(!r.error.empty(), SL);
+        }
+
+        // default options use all hardware threads
+        {
+            auto results = svgdom::load_batch(utki::make_span(buffers));
+            tst::check_eq(results.size(), buffers.size(), SL);
+            for(size_t i = 0; i != results.size(); i += 3){
+                tst::check(results[i], SL);
+                tst::check_eq(results[i].dom->to_string(), expected, SL);
+                tst::check(!results[i + 1], SL);
+            }
+        }
+    });
 });
 }
@@ -0,0 +1,104 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/node_table.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace{
+const tst::set set("node_table", [](auto& suite){
+	suite.add("links_and_depths", [](){
+		auto dom = svgdom::load(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" id="root">
+	<defs id="defs">
+		<linearGradient id="lg"><stop/><stop/></linearGradient>
+	</defs>
+	<g id="g1">
+		<rect id="r1"/>
+		<g id="g2"><circle id="c1"/></g>
+		<path id="p1"/>
+	</g>
+	<use id="u1"/>
+</svg>)qwertyuiop"sv);
+		tst::check(dom, SL);
+
+		svgdom::node_table table(*dom);
+
+		// nodes are in document order
+		std::vector<std::string> ids;
+		for(const auto& n : table.get_nodes()){
+			ids.push_back(n.element->id);
+		}
+		tst::check_eq(
+				ids,
+				std::vector<std::string>{"root", "defs", "lg", "", "", "g1", "r1", "g2", "c1", "p1", "u1"},
+				SL
+			);
+
+		const auto& root = table[svgdom::node_table::root()];
+		tst::check(root.element == dom.get(), SL);
+		tst::check(root.kind == svgdom::element_kind::svg, SL);
+		tst::check_eq(root.parent, svgdom::node_table::npos, SL);
+		tst::check_eq(root.next_sibling, svgdom::node_table::npos, SL);
+		tst::check_eq(root.depth, uint32_t(0), SL);
+
+		// children of the root
+		std::vector<std::string> children;
+		for(auto h = root.first_child; h != svgdom::node_table::npos; h = table[h].next_sibling){
+			tst::check_eq(table[h].parent, svgdom::node_table::root(), SL);
+			tst::check_eq(table[h].depth, uint32_t(1), SL);
+			children.push_back(table[h].element->id);
+		}
+		tst::check_eq(children, std::vector<std::string>{"defs", "g1", "u1"}, SL);
+
+		// navigation up from the deepest element
+		auto g1 = dynamic_cast<const svgdom::g_element*>(dom->children[1].get());
+		tst::check(g1, SL);
+		auto g2_element = dynamic_cast<const svgdom::g_element*>(g1->children[1].get());
+		tst::check(g2_element, SL);
+		auto c1 = table.find(*g2_element->children[0]);
+		tst::check_eq(c1, svgdom::node_table::handle(8), SL);
+		tst::check(table[c1].kind == svgdom::element_kind::circle, SL);
+		tst::check_eq(table[c1].depth, uint32_t(3), SL);
+		tst::check_eq(table[c1].first_child, svgdom::node_table::npos, SL);
+
+		auto g2 = table[c1].parent;
+		tst::check(table[g2].kind == svgdom::element_kind::g, SL);
+		tst::check_eq(table[g2].element->id, "g2"s, SL);
+		tst::check_eq(table[table[g2].next_sibling].element->id, "p1"s, SL);
+		tst::check_eq(table[table[g2].parent].element->id, "g1"s, SL);
+
+		tst::check(table[3].kind == svgdom::element_kind::gradient_stop, SL);
+		tst::check(table[2].kind == svgdom::element_kind::linear_gradient, SL);
+
+		svgdom::g_element not_in_table;
+		tst::check_eq(table.find(not_in_table), svgdom::node_table::npos, SL);
+	});
+
+	suite.add("same_elements_as_visitor", [](){
+		auto dom = svgdom::load(fsif::native_file("samples_data/tiger.svg"));
+		tst::check(dom, SL);
+
+		class collector : public svgdom::const_visitor{
+		public:
+			std::vector<const svgdom::element*> elements;
+
+			void default_visit(const svgdom::element& e)override{
+				this->elements.push_back(&e);
+			}
+		} c;
+		dom->accept(c);
+
+		svgdom::node_table table(*dom);
+		tst::check_eq(table.size(), c.elements.size(), SL);
+
+		for(size_t i = 0; i != table.size(); ++i){
+			tst::check(table[svgdom::node_table::handle(i)].element == c.elements[i], SL);
+		}
+	});
+});
+}
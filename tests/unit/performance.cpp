@@ -1,10 +1,221 @@
 #include <tst/set.hpp>
 #include <tst/check.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <utki/time.hpp>
+#include <utki/util.hpp>
 #include <fsif/native_file.hpp>
 
 #include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/pipelined_loader.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/computed_styles.hpp"
+#include "../../src/svgdom/util/css_index.hpp"
+#include "../../src/svgdom/util/finder_by_class.hpp"
+#include "../../src/svgdom/util/finder_by_id.hpp"
+#include "../../src/svgdom/util/style_stack.hpp"
+#include "../../src/svgdom/util/style_value_pool.hpp"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+namespace{
+struct file_loading_times{
+	uint32_t native_file_ms;
+	uint32_t istream_ms;
+	uint32_t read_whole_ms;
+};
+
+file_loading_times measure_file_loading(const std::string& path, unsigned num_iterations){
+	file_loading_times ret{};
+
+	auto start = utki::get_ticks_ms();
+	for(unsigned i = 0; i != num_iterations; ++i){
+		// native file is memory mapped
+		auto dom = svgdom::load(fsif::native_file(path));
+		tst::check(dom != nullptr, SL);
+	}
+	ret.native_file_ms = utki::get_ticks_ms() - start;
+
+	start = utki::get_ticks_ms();
+	for(unsigned i = 0; i != num_iterations; ++i){
+		// std::istream is read by chunks
+		std::ifstream s(path, std::ios::binary);
+		auto dom = svgdom::load(s);
+		tst::check(dom != nullptr, SL);
+	}
+	ret.istream_ms = utki::get_ticks_ms() - start;
+
+	start = utki::get_ticks_ms();
+	for(unsigned i = 0; i != num_iterations; ++i){
+		auto buf = fsif::native_file(path).load();
+		auto dom = svgdom::load(utki::make_span(buf));
+		tst::check(dom != nullptr, SL);
+	}
+	ret.read_whole_ms = utki::get_ticks_ms() - start;
+
+	return ret;
+}
+
+class element_counter : public svgdom::const_visitor{
+public:
+	size_t count = 0;
+
+	void default_visit(const svgdom::element& e)override{
+		++this->count;
+	}
+};
+
+// sums up number of path segments, streamed elements are destroyed right after the visit
+class path_segment_counter : public svgdom::visitor{
+public:
+	size_t num_elements = 0;
+	size_t num_segments = 0;
+
+	void visit(svgdom::path_element& e)override{
+		this->num_segments += e.path.size();
+		this->default_visit(e);
+	}
+
+	void default_visit(svgdom::element& e)override{
+		++this->num_elements;
+	}
+
+	void default_visit(svgdom::element& e, svgdom::container& c)override{
+		++this->num_elements;
+		this->relay_accept(c);
+	}
+};
+
+// Stream buffer which spends some CPU time on producing each chunk of data,
+// like a decompressor does.
+class slow_source_buffer : public std::streambuf{
+	std::string_view data;
+	size_t pos = 0;
+	std::vector<char> chunk;
+
+public:
+	uint32_t checksum = 0;
+
+	slow_source_buffer(std::string_view data, size_t chunk_size) :
+			data(data),
+			chunk(chunk_size)
+	{}
+
+	size_t read(utki::span<char> buf){
+		auto n = std::min(buf.size(), this->data.size() - this->pos);
+		for(size_t i = 0; i != n; ++i){
+			char c = this->data[this->pos + i];
+			// some work per byte
+			for(unsigned j = 0; j != 16; ++j){
+				this->checksum = (this->checksum << 1) ^ (this->checksum >> 31) ^ uint32_t(c);
+			}
+			buf[i] = c;
+		}
+		this->pos += n;
+		return n;
+	}
+
+protected:
+	int_type underflow()override{
+		auto n = this->read(utki::make_span(this->chunk));
+		if(n == 0){
+			return traits_type::eof();
+		}
+		this->setg(this->chunk.data(), this->chunk.data(), this->chunk.data() + n);
+		return traits_type::to_int_type(this->chunk.front());
+	}
+};
+
+// collects values of given attribute from all SVG files of the directory
+std::vector<std::string> collect_attribute_values(const std::string& dir, std::string_view attribute){
+	std::vector<std::string> ret;
+
+	auto needle = " "s + std::string(attribute) + "=\"";
+
+	for(const auto& entry : std::filesystem::directory_iterator(dir)){
+		if(entry.path().extension() != ".svg"){
+			continue;
+		}
+		auto buf = fsif::native_file(entry.path().string()).load();
+		std::string_view content(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+		for(auto pos = content.find(needle); pos != std::string_view::npos; pos = content.find(needle, pos)){
+			pos += needle.size();
+			auto end = content.find('"', pos);
+			if(end == std::string_view::npos){
+				break;
+			}
+			ret.emplace_back(content.substr(pos, end - pos));
+			pos = end;
+		}
+	}
+
+	return ret;
+}
+
+// generates synthetic icon of 1 to 5 kilobytes, the size depends on the seed
+std::string make_icon(unsigned seed){
+	std::stringstream ss;
+	ss << R"(<svg xmlns="http://www.w3.org/2000/svg" width="24" height="24" viewBox="0 0 24 24">)";
+	ss << R"(<defs><linearGradient id="g)" << seed << R"("><stop offset="0" stop-color="#ff0000"/><stop offset="1" stop-color="#0000ff"/></linearGradient></defs>)";
+
+	unsigned num_paths = 4 + seed % 17;
+	for(unsigned i = 0; i != num_paths; ++i){
+		ss << R"x(<g transform="translate()x" << i % 3 << "," << i % 5 << R"x()">)x"
+			<< R"x(<path style="fill:url(#g)x" << seed << R"x();stroke:#000000;stroke-width:0.5" d="M 2,2 L 22,2 C 20,4 18,6 16,8 Q 14,10 12,12 A 5,5 0 1 0 10,14 H 4 V 20 z"/>)x"
+			<< R"(<circle cx="12" cy="12" r=")" << i % 10 + 1 << R"(" fill="#00ff00"/></g>)";
+	}
+	ss << "</svg>";
+
+	return ss.str();
+}
+
+// The benchmarks take long and some of them need hundreds of megabytes of memory and disk space,
+// so they are only run when the SVGDOM_BENCHMARKS environment variable is set, e.g.
+//   SVGDOM_BENCHMARKS=1 make test
+bool benchmarks_enabled(){
+	return std::getenv("SVGDOM_BENCHMARKS") != nullptr;
+}
+
+size_t num_coordinates(const svgdom::path_element::step& s){
+	using type = svgdom::path_element::step::type;
+	switch(s.type_v){
+		case type::close:
+			return 0;
+		case type::horizontal_line_abs:
+		case type::horizontal_line_rel:
+		case type::vertical_line_abs:
+		case type::vertical_line_rel:
+			return 1;
+		case type::cubic_abs:
+		case type::cubic_rel:
+			return 6;
+		case type::cubic_smooth_abs:
+		case type::cubic_smooth_rel:
+		case type::quadratic_abs:
+		case type::quadratic_rel:
+			return 4;
+		case type::arc_abs:
+		case type::arc_rel:
+			return 7;
+		default:
+			return 2;
+	}
+}
+}
 
 namespace{
 const tst::set set("performance", [](auto& suite){
@@ -22,5 +233,1020 @@ const tst::set set("performance", [](auto& suite){
 			utki::log([&](auto&o){o << "SVG parsed in " << float(utki::get_ticks_ms() - parse_start) / 1000.0f << " sec." << std::endl;});
 		}
 	});
+
+	if(!benchmarks_enabled()){
+		return;
+	}
+
+	suite.add("mmap_vs_chunked_back_svg", [](){
+		constexpr unsigned num_iterations = 5;
+
+		auto t = measure_file_loading("samples_data/back.svg", num_iterations);
+
+		utki::log([&](auto&o){
+			o << "back.svg, " << num_iterations << " loads:" << std::endl;
+			o << "  mapped native file: " << float(t.native_file_ms) / 1000.0f << " sec." << std::endl;
+			o << "  chunked istream:    " << float(t.istream_ms) / 1000.0f << " sec." << std::endl;
+			o << "  read whole + parse: " << float(t.read_whole_ms) / 1000.0f << " sec." << std::endl;
+		});
+	});
+
+	suite.add("mmap_vs_chunked_synthetic_500mb", [](){
+		constexpr size_t file_size = size_t(500) * 1024 * 1024;
+
+		auto path = (std::filesystem::temp_directory_path() / "svgdom_synthetic_500mb.svg").string();
+
+		// generate a big document which mostly consists of elements unknown to svgdom,
+		// so that the resulting DOM stays small and the file reading and XML tokenizing dominate
+		{
+			std::ofstream s(path, std::ios::binary);
+			s << R"(<svg xmlns="http://www.w3.org/2000/svg" width="100" height="100">)" << '\n';
+
+			std::string block;
+			for(unsigned i = 0; i != 1000; ++i){
+				block += R"(<metadata id="m" class="c">lorem ipsum dolor sit amet, consectetur adipiscing elit</metadata>)";
+				block += '\n';
+			}
+			block += R"(<path d="M 10,10 L 20,20 C 30,30 40,40 50,50 z" fill="red"/>)";
+			block += '\n';
+
+			for(size_t written = 0; written < file_size; written += block.size()){
+				s << block;
+			}
+			s << "</svg>" << '\n';
+		}
+
+		utki::scope_exit file_remover([&](){
+			std::filesystem::remove(path);
+		});
+
+		constexpr unsigned num_iterations = 1;
+
+		auto t = measure_file_loading(path, num_iterations);
+
+		utki::log([&](auto&o){
+			o << "synthetic 500 MB document:" << std::endl;
+			o << "  mapped native file: " << float(t.native_file_ms) / 1000.0f << " sec." << std::endl;
+			o << "  chunked istream:    " << float(t.istream_ms) / 1000.0f << " sec." << std::endl;
+			o << "  read whole + parse: " << float(t.read_whole_ms) / 1000.0f << " sec." << std::endl;
+		});
+	});
+
+	suite.add("istream_vs_string_view", [](){
+		auto buf = fsif::native_file("samples_data/back.svg").load();
+		auto str = std::string(buf.begin(), buf.end());
+
+		constexpr unsigned num_iterations = 5;
+
+		auto start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			auto dom = svgdom::load(std::string_view(str));
+			tst::check(dom != nullptr, SL);
+		}
+		auto string_view_ms = utki::get_ticks_ms() - start;
+
+		start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			std::istringstream s(str);
+			auto dom = svgdom::load(s);
+			tst::check(dom != nullptr, SL);
+		}
+		auto istream_ms = utki::get_ticks_ms() - start;
+
+		start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			std::istringstream s(str);
+			auto dom = svgdom::load(s, str.size());
+			tst::check(dom != nullptr, SL);
+		}
+		auto istream_hinted_ms = utki::get_ticks_ms() - start;
+
+		auto mb_per_sec = [&](uint32_t ms){
+			return float(str.size() * num_iterations) / float(1024 * 1024) / (float(std::max(ms, uint32_t(1))) / 1000.0f);
+		};
+
+		utki::log([&](auto&o){
+			o << "back.svg, " << num_iterations << " loads:" << std::endl;
+			o << "  std::string_view:         " << mb_per_sec(string_view_ms) << " MB/sec" << std::endl;
+			o << "  std::istream:             " << mb_per_sec(istream_ms) << " MB/sec" << std::endl;
+			o << "  std::istream, size hint:  " << mb_per_sec(istream_hinted_ms) << " MB/sec" << std::endl;
+		});
+	});
+
+	suite.add("attributes_per_second", [](){
+		constexpr unsigned num_elements = 100000;
+
+		// each element has 14 attributes: known ones, presentation attributes, prefixed and unknown ones
+		constexpr unsigned num_attributes_per_element = 14;
+
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" xmlns:svg="http://www.w3.org/2000/svg">)";
+		for(unsigned i = 0; i != num_elements; ++i){
+			ss << R"(<rect id="r)" << i << R"(" class="a b" x="10" y="20" width="30%" height="40" rx="1" ry="2" )"
+					R"x(fill="#ff0000" stroke="blue" stroke-width="2" svg:opacity="0.5" transform="translate(1,2)" )x"
+					R"(data-unknown="value" xlink:title="t"/>)";
+		}
+		ss << "</svg>";
+		auto str = ss.str();
+
+		constexpr unsigned num_iterations = 3;
+
+		auto start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			auto dom = svgdom::load(std::string_view(str));
+			tst::check(dom != nullptr, SL);
+			tst::check_eq(dom->children.size(), size_t(num_elements), SL);
+		}
+		auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+		auto num_attributes = uint64_t(num_elements) * num_attributes_per_element * num_iterations;
+
+		utki::log([&](auto&o){
+			o << num_attributes << " attributes parsed in " << float(ms) / 1000.0f << " sec, ";
+			o << float(num_attributes) / (float(ms) / 1000.0f) << " attributes/sec" << std::endl;
+		});
+	});
+
+	suite.add("keyword_lookups", [](){
+		constexpr unsigned num_iterations = 1000000;
+
+		auto measure = [](std::string_view name, size_t num_lookups, const std::function<size_t()>& func){
+			auto start = utki::get_ticks_ms();
+			size_t checksum = func();
+			auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+			utki::log([&](auto&o){
+				o << "  " << name << ": " << float(num_lookups) / (float(ms) / 1000.0f) << " lookups/sec (checksum " << checksum << ")" << std::endl;
+			});
+		};
+
+		std::vector<std::string_view> property_names;
+		for(size_t i = size_t(svgdom::style_property::unknown) + 1; i != size_t(svgdom::style_property::enum_size); ++i){
+			property_names.push_back(svgdom::styleable::property_to_string(svgdom::style_property(i)));
+		}
+		property_names.emplace_back("not-a-property");
+
+		const std::array<std::string_view, 8> color_names = {
+			"black", "white", "lightgoldenrodyellow", "cornflowerblue", "red", "darkslategray", "yellowgreen", "notacolor"
+		};
+
+		const std::array<std::string_view, 4> display_names = {"inline", "none", "table-cell", "bad"};
+
+		const std::string_view path_commands = "MmLlHhVvCcSsQqTtAaZz0,.";
+
+		utki::log([&](auto&o){o << "keyword lookups:" << std::endl;});
+
+		measure("property names", num_iterations * property_names.size(), [&](){
+			size_t sum = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(auto n : property_names){
+					sum += size_t(svgdom::styleable::string_to_property(n));
+				}
+			}
+			return sum;
+		});
+
+		measure("color names", num_iterations * color_names.size(), [&](){
+			size_t sum = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(auto n : color_names){
+					sum += svgdom::parse_paint(n).index();
+				}
+			}
+			return sum;
+		});
+
+		measure("display keywords", num_iterations * display_names.size(), [&](){
+			size_t sum = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(auto n : display_names){
+					sum += size_t(std::get<svgdom::display>(svgdom::parse_display(n)));
+				}
+			}
+			return sum;
+		});
+
+		measure("visibility keywords", num_iterations * 3, [&](){
+			size_t sum = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(auto n : {"visible"sv, "collapse"sv, "bad"sv}){
+					sum += size_t(std::get<svgdom::visibility>(svgdom::parse_visibility(n)));
+				}
+			}
+			return sum;
+		});
+
+		measure("path commands", num_iterations * path_commands.size(), [&](){
+			size_t sum = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(auto c : path_commands){
+					sum += size_t(svgdom::path_element::step::char_to_type(c));
+				}
+			}
+			return sum;
+		});
+
+		measure("transform names", num_iterations / 10, [&](){
+			size_t sum = 0;
+			for(unsigned i = 0; i != num_iterations / 10; ++i){
+				sum += svgdom::transformable::parse("skewY(1)").size();
+			}
+			return sum;
+		});
+	});
+
+	suite.add("style_storage", [](){
+		constexpr unsigned num_paths = 100000;
+		constexpr unsigned num_iterations = 10;
+
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+		for(unsigned i = 0; i != num_paths; ++i){
+			if(i % 4 == 0){
+				ss << R"(<path style="fill:#ff0000;stroke:blue;stroke-width:2;opacity:0.5;fill-rule:evenodd" d="M 0,0 z"/>)";
+			}else if(i % 2 == 0){
+				ss << R"(<path fill="#00ff00" stroke="none" d="M 0,0 z"/>)";
+			}else{
+				ss << R"(<path fill="#0000ff" d="M 0,0 z"/>)";
+			}
+		}
+		ss << "</svg>";
+
+		auto dom = svgdom::load(ss.str());
+		tst::check(dom != nullptr, SL);
+
+		using std_map = std::map<svgdom::style_property, svgdom::style_value>;
+
+		std::vector<const svgdom::styleable*> styleables;
+		std::vector<std_map> std_maps;
+		for(const auto& c : dom->children){
+			auto s = dynamic_cast<const svgdom::styleable*>(c.get());
+			tst::check(s, SL);
+			styleables.push_back(s);
+			for(const auto& m : {&s->styles, &s->presentation_attributes}){
+				std_maps.emplace_back(m->begin(), m->end());
+			}
+		}
+
+		// red-black tree node is three pointers and a color in addition to the value
+		constexpr size_t map_node_overhead = sizeof(void*) * 4;
+
+		size_t num_entries = 0;
+		size_t std_map_bytes = 0;
+		size_t style_map_bytes = 0;
+		for(const auto& m : std_maps){
+			num_entries += m.size();
+			std_map_bytes += sizeof(std_map) + m.size() * (sizeof(std_map::value_type) + map_node_overhead);
+			style_map_bytes += sizeof(svgdom::style_map) + m.size() * sizeof(svgdom::style_map::value_type);
+		}
+
+		utki::log([&](auto&o){
+			o << std_maps.size() << " style maps, " << num_entries << " entries, estimated footprint:" << std::endl;
+			o << "  std::map:  " << std_map_bytes << " bytes" << std::endl;
+			o << "  style_map: " << style_map_bytes << " bytes" << std::endl;
+		});
+
+		auto num_lookups = size_t(num_iterations) * std_maps.size() * size_t(svgdom::style_property::enum_size);
+
+		auto std_map_start = utki::get_ticks_ms();
+		size_t std_map_found = 0;
+		for(unsigned i = 0; i != num_iterations; ++i){
+			for(const auto& m : std_maps){
+				for(size_t p = 0; p != size_t(svgdom::style_property::enum_size); ++p){
+					if(m.find(svgdom::style_property(p)) != m.end()){
+						++std_map_found;
+					}
+				}
+			}
+		}
+		auto std_map_ms = std::max(utki::get_ticks_ms() - std_map_start, uint32_t(1));
+
+		auto style_map_start = utki::get_ticks_ms();
+		size_t style_map_found = 0;
+		for(unsigned i = 0; i != num_iterations; ++i){
+			for(const auto& s : styleables){
+				for(const auto& m : {&s->styles, &s->presentation_attributes}){
+					for(size_t p = 0; p != size_t(svgdom::style_property::enum_size); ++p){
+						if(m->find(svgdom::style_property(p)) != m->end()){
+							++style_map_found;
+						}
+					}
+				}
+			}
+		}
+		auto style_map_ms = std::max(utki::get_ticks_ms() - style_map_start, uint32_t(1));
+
+		tst::check_eq(style_map_found, std_map_found, SL);
+
+		utki::log([&](auto&o){
+			o << "  std::map lookups:  " << float(num_lookups) / (float(std_map_ms) / 1000.0f) << " lookups/sec" << std::endl;
+			o << "  style_map lookups: " << float(num_lookups) / (float(style_map_ms) / 1000.0f) << " lookups/sec" << std::endl;
+		});
+	});
+
+	suite.add("compact_style_values", [](){
+		class collector : public svgdom::const_visitor{
+		public:
+			std::vector<const svgdom::style_map*> maps;
+
+			void default_visit(const svgdom::element& e)override{
+				if(auto s = svgdom::cast_to_styleable(&e)){
+					this->maps.push_back(&s->styles);
+					this->maps.push_back(&s->presentation_attributes);
+				}
+			}
+		};
+
+		using styles = std::vector<std::pair<svgdom::style_property, svgdom::style_value>>;
+		using compact_styles = std::vector<std::pair<svgdom::style_property, svgdom::compact_style_value>>;
+
+		std::vector<styles> all_styles;
+		std::vector<compact_styles> all_compact_styles;
+
+		size_t style_value_bytes = 0;
+		size_t compact_bytes = 0;
+
+		for(const auto& entry : std::filesystem::directory_iterator("samples_data")){
+			if(entry.path().extension() != ".svg"){
+				continue;
+			}
+
+			auto dom = svgdom::load(fsif::native_file(entry.path().string()));
+			tst::check(dom, SL);
+
+			collector c;
+			dom->accept(c);
+
+			// one pool per document
+			svgdom::style_value_pool pool;
+
+			for(const auto& m : c.maps){
+				auto& s = all_styles.emplace_back(m->begin(), m->end());
+				auto& cs = all_compact_styles.emplace_back();
+				for(const auto& [p, v] : s){
+					cs.emplace_back(p, pool.encode(v));
+
+					style_value_bytes += sizeof(v);
+					if(auto str = std::get_if<std::string>(&v); str && str->capacity() > std::string().capacity()){
+						style_value_bytes += str->capacity();
+					}else if(auto dashes = std::get_if<std::vector<svgdom::length>>(&v)){
+						style_value_bytes += dashes->capacity() * sizeof(svgdom::length);
+					}
+					compact_bytes += sizeof(svgdom::compact_style_value);
+				}
+			}
+
+			compact_bytes += pool.get_memory_size();
+		}
+
+		utki::log([&](auto&o){
+			o << "style values of samples corpus:" << std::endl;
+			o << "  style_value:         " << style_value_bytes << " bytes" << std::endl;
+			o << "  compact_style_value: " << compact_bytes << " bytes, including pools" << std::endl;
+		});
+
+		constexpr unsigned num_iterations = 2000;
+
+		auto copy = [](const auto& all, std::string_view name){
+			size_t num_copied = 0;
+
+			auto start = utki::get_ticks_ms();
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(const auto& s : all){
+					auto copied = s;
+					num_copied += copied.size();
+				}
+			}
+			auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+			utki::log([&](auto&o){
+				o << "  copying " << name << ": " << float(num_copied) / (float(ms) / 1000.0f) << " values/sec" << std::endl;
+			});
+		};
+
+		copy(all_styles, "style_value");
+		copy(all_compact_styles, "compact_style_value");
+	});
+
+	suite.add("finders_by_id_and_class", [](){
+		constexpr unsigned num_elements = 100000;
+		constexpr unsigned num_classes = 100;
+		constexpr unsigned num_iterations = 10;
+
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+		for(unsigned i = 0; i != num_elements; ++i){
+			ss << R"(<rect id="element_id_)" << i << R"(" class="class_)" << i % num_classes << R"( common"/>)";
+		}
+		ss << "</svg>";
+
+		auto dom = svgdom::load(ss.str());
+		tst::check(dom != nullptr, SL);
+
+		std::vector<std::string> ids;
+		for(const auto& c : dom->children){
+			ids.push_back(c->id);
+		}
+
+		// baseline: string keyed hash map, as the finders were before the atom tables
+		auto map_start = utki::get_ticks_ms();
+		std::unordered_map<std::string, const svgdom::element*> map;
+		{
+			class cache_creator : public svgdom::const_visitor{
+			public:
+				std::unordered_map<std::string, const svgdom::element*>& map;
+				cache_creator(decltype(map) map) : map(map){}
+				void default_visit(const svgdom::element& e)override{
+					if(!e.id.empty()){
+						this->map.insert(std::make_pair(e.id, &e));
+					}
+				}
+			} cc(map);
+			dom->accept(cc);
+		}
+		auto map_ms = utki::get_ticks_ms() - map_start;
+
+		auto finder_start = utki::get_ticks_ms();
+		svgdom::finder_by_id finder(*dom);
+		auto finder_ms = utki::get_ticks_ms() - finder_start;
+
+		tst::check_eq(finder.size(), map.size(), SL);
+
+		std::vector<svgdom::atom_table::atom> atoms;
+		for(const auto& id : ids){
+			atoms.push_back(finder.get_atoms().find(id));
+		}
+
+		auto num_lookups = size_t(num_iterations) * ids.size();
+
+		auto measure = [&](std::string_view name, const std::function<size_t()>& func){
+			auto start = utki::get_ticks_ms();
+			size_t num_found = func();
+			auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+			tst::check_eq(num_found, num_lookups, SL);
+
+			utki::log([&](auto&o){
+				o << "  " << name << ": " << float(num_lookups) / (float(ms) / 1000.0f) << " lookups/sec" << std::endl;
+			});
+		};
+
+		utki::log([&](auto&o){
+			o << num_elements << " elements with ids, construction:" << std::endl;
+			o << "  string keyed map: " << float(map_ms) / 1000.0f << " sec." << std::endl;
+			o << "  finder_by_id:     " << float(finder_ms) / 1000.0f << " sec." << std::endl;
+			o << "lookups by id:" << std::endl;
+		});
+
+		measure("string keyed map", [&](){
+			size_t num_found = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(const auto& id : ids){
+					num_found += map.find(id) != map.end() ? 1 : 0;
+				}
+			}
+			return num_found;
+		});
+
+		measure("finder_by_id, by string", [&](){
+			size_t num_found = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(const auto& id : ids){
+					num_found += finder.find(id) ? 1 : 0;
+				}
+			}
+			return num_found;
+		});
+
+		measure("finder_by_id, by atom", [&](){
+			size_t num_found = 0;
+			for(unsigned i = 0; i != num_iterations; ++i){
+				for(auto a : atoms){
+					num_found += finder.find(a) ? 1 : 0;
+				}
+			}
+			return num_found;
+		});
+
+		auto class_finder_start = utki::get_ticks_ms();
+		svgdom::finder_by_class class_finder(*dom);
+		auto class_finder_ms = utki::get_ticks_ms() - class_finder_start;
+
+		tst::check_eq(class_finder.size(), size_t(num_classes + 1), SL);
+		tst::check_eq(class_finder.find("common").size(), size_t(num_elements), SL);
+
+		utki::log([&](auto&o){
+			o << "finder_by_class construction: " << float(class_finder_ms) / 1000.0f << " sec." << std::endl;
+		});
+	});
+
+	suite.add("computed_styles_vs_style_stack", [](){
+		constexpr unsigned depth = 200;
+		constexpr unsigned width = 10000;
+
+		const std::array<svgdom::style_property, 5> properties = {
+			svgdom::style_property::fill,
+			svgdom::style_property::stroke,
+			svgdom::style_property::stroke_width,
+			svgdom::style_property::opacity,
+			svgdom::style_property::font_size
+		};
+
+		// deep: nested groups, each declaring one of the properties, with a rect at each level
+		std::stringstream deep_ss;
+		deep_ss << R"(<svg xmlns="http://www.w3.org/2000/svg" fill="red">)";
+		for(unsigned i = 0; i != depth; ++i){
+			deep_ss << "<g" << (i % 3 == 0 ? R"( stroke="blue")" : "") << (i % 7 == 0 ? R"( style="opacity:0.5;fill:inherit")" : "") << ">";
+			deep_ss << R"(<rect width="10" height="10"/>)";
+		}
+		for(unsigned i = 0; i != depth; ++i){
+			deep_ss << "</g>";
+		}
+		deep_ss << "</svg>";
+
+		// wide: lots of siblings in one group
+		std::stringstream wide_ss;
+		wide_ss << R"(<svg xmlns="http://www.w3.org/2000/svg"><g fill="red" stroke-width="2">)";
+		for(unsigned i = 0; i != width; ++i){
+			wide_ss << R"(<rect width="10" height="10")" << (i % 2 == 0 ? R"( stroke="blue")" : "") << "/>";
+		}
+		wide_ss << "</g></svg>";
+
+		auto measure = [&](std::string_view name, const std::string& str){
+			auto dom = svgdom::load(str);
+			tst::check(dom != nullptr, SL);
+
+			class traverse_visitor : public svgdom::const_visitor{
+			public:
+				const decltype(properties)& props;
+				svgdom::style_stack ss;
+				size_t num_values = 0;
+
+				traverse_visitor(const decltype(properties)& props) : props(props){}
+
+				void get_values(){
+					for(auto p : this->props){
+						this->num_values += this->ss.get_style_property(p) ? 1 : 0;
+					}
+				}
+
+				void default_visit(const svgdom::element& e, const svgdom::container& c)override{
+					auto s = svgdom::cast_to_styleable(&e);
+					if(!s){
+						this->relay_accept(c);
+						return;
+					}
+					svgdom::style_stack::push ss_push(this->ss, *s);
+					this->get_values();
+					this->relay_accept(c);
+				}
+
+				void default_visit(const svgdom::element& e)override{
+					auto s = svgdom::cast_to_styleable(&e);
+					if(!s){
+						return;
+					}
+					svgdom::style_stack::push ss_push(this->ss, *s);
+					this->get_values();
+				}
+			} tv(properties);
+
+			auto stack_start = utki::get_ticks_us();
+			dom->accept(tv);
+			auto stack_us = utki::get_ticks_us() - stack_start;
+
+			auto computed_start = utki::get_ticks_us();
+			svgdom::computed_styles cs(*dom);
+			auto computed_build_us = utki::get_ticks_us() - computed_start;
+			size_t num_values = 0;
+			for(size_t h = 0; h != cs.size(); ++h){
+				for(auto p : properties){
+					num_values += cs.get(svgdom::node_table::handle(h), p) ? 1 : 0;
+				}
+			}
+			auto computed_us = utki::get_ticks_us() - computed_start;
+
+			tst::check_eq(num_values, tv.num_values, SL);
+
+			utki::log([&](auto&o){
+				o << name << ", " << cs.size() << " elements, " << properties.size() << " properties per element:" << std::endl;
+				o << "  style_stack:     " << float(stack_us) / 1000.0f << " ms" << std::endl;
+				o << "  computed_styles: " << float(computed_us) / 1000.0f << " ms (" << float(computed_build_us) / 1000.0f << " ms construction)" << std::endl;
+			});
+		};
+
+		measure("deep", deep_ss.str());
+		measure("wide", wide_ss.str());
+	});
+
+	suite.add("css_rule_index", [](){
+		constexpr unsigned num_class_rules = 1000;
+		constexpr unsigned num_id_rules = 200;
+		constexpr unsigned num_tag_rules = 20;
+		constexpr unsigned num_elements = 5000;
+
+		const std::array<std::string_view, 4> tags = {"rect", "circle", "path", "ellipse"};
+
+		// document as exported by design tools: lots of class rules, each element has its own classes
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg"><style type="text/css">)";
+		for(unsigned i = 0; i != num_class_rules; ++i){
+			ss << ".cls_" << i << "{fill:rgb(" << i % 256 << "," << i / 256 << ",0)}";
+			if(i % 3 == 0){
+				ss << "g .cls_" << i << "{stroke:blue}";
+			}
+		}
+		for(unsigned i = 0; i != num_id_rules; ++i){
+			ss << "#element_" << i * 10 << "{opacity:0.5}";
+		}
+		for(unsigned i = 0; i != num_tag_rules; ++i){
+			ss << tags[i % tags.size()] << "{stroke-width:" << i << "}";
+		}
+		ss << "</style><g>";
+		for(unsigned i = 0; i != num_elements; ++i){
+			auto tag = tags[i % tags.size()];
+			ss << "<" << tag << R"( id="element_)" << i << R"(" class="cls_)" << i % num_class_rules << " cls_" << (i * 7) % num_class_rules << R"("/>)";
+		}
+		ss << "</g></svg>";
+
+		auto dom = svgdom::load(ss.str());
+		tst::check(dom != nullptr, SL);
+
+		auto style = dynamic_cast<const svgdom::style_element*>(dom->children.front().get());
+		tst::check(style, SL);
+		auto g = dynamic_cast<const svgdom::g_element*>(dom->children.back().get());
+		tst::check(g, SL);
+
+		class crawler : public cssom::xml_dom_crawler{
+		public:
+			std::array<const svgdom::styleable*, 3> stack{};
+			size_t pos = 2;
+
+			const cssom::styleable& get()override{
+				return *this->stack.at(this->pos);
+			}
+
+			bool move_up()override{
+				if(this->pos == 0){
+					return false;
+				}
+				--this->pos;
+				return true;
+			}
+
+			bool move_left()override{
+				return false;
+			}
+
+			void reset()override{
+				this->pos = this->stack.size() - 1;
+			}
+		} c;
+		c.stack[0] = dom.get();
+		c.stack[1] = g;
+
+		const std::array<svgdom::style_property, 4> properties = {
+			svgdom::style_property::fill,
+			svgdom::style_property::stroke,
+			svgdom::style_property::stroke_width,
+			svgdom::style_property::opacity
+		};
+
+		auto measure = [&](const std::function<cssom::sheet::query_result(uint32_t)>& get_property_value){
+			std::vector<const cssom::property_value_base*> ret;
+			for(const auto& e : g->children){
+				c.stack[2] = svgdom::cast_to_styleable(e.get());
+				tst::check(c.stack[2], SL);
+				for(auto p : properties){
+					ret.push_back(get_property_value(uint32_t(p)).value);
+				}
+			}
+			return ret;
+		};
+
+		auto sheet_start = utki::get_ticks_us();
+		auto sheet_values = measure([&](uint32_t p){return style->css.get_property_value(c, p);});
+		auto sheet_us = utki::get_ticks_us() - sheet_start;
+
+		auto index_start = utki::get_ticks_us();
+		svgdom::css_index index(style->css);
+		auto index_build_us = utki::get_ticks_us() - index_start;
+		auto index_values = measure([&](uint32_t p){return index.get_property_value(c, p);});
+		auto index_us = utki::get_ticks_us() - index_start;
+
+		tst::check(sheet_values == index_values, SL);
+
+		utki::log([&](auto&o){
+			o << style->css.styles.size() << " rules, " << num_elements << " elements, " << properties.size() << " properties per element:" << std::endl;
+			o << "  sheet:     " << float(sheet_us) / 1000.0f << " ms" << std::endl;
+			o << "  css_index: " << float(index_us) / 1000.0f << " ms (" << float(index_build_us) / 1000.0f << " ms construction)" << std::endl;
+		});
+	});
+
+	suite.add("coordinates_per_second", [](){
+		auto paths = collect_attribute_values("samples_data", "d");
+		auto points = collect_attribute_values("samples_data", "points");
+
+		constexpr unsigned num_iterations = 200;
+
+		size_t num_coords = 0;
+		auto start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			for(const auto& d : paths){
+				for(const auto& step : svgdom::path_element::parse(d)){
+					num_coords += num_coordinates(step);
+				}
+			}
+			for(const auto& p : points){
+				num_coords += svgdom::polyline_shape::parse(p).size() * 2;
+			}
+		}
+		auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+		utki::log([&](auto&o){
+			o << paths.size() << " paths and " << points.size() << " point lists from samples_data, " << num_iterations << " iterations:" << std::endl;
+			o << "  " << num_coords << " coordinates parsed in " << float(ms) / 1000.0f << " sec, ";
+			o << float(num_coords) / (float(ms) / 1000.0f) << " coordinates/sec" << std::endl;
+		});
+	});
+
+	suite.add("deep_nesting", [](){
+		constexpr unsigned depth = 1000;
+		constexpr unsigned num_trees = 100;
+
+		// deeply nested groups, namespaces are declared only in the root element,
+		// as it is usually the case, prefixed attributes are used all the way down
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink">)";
+		for(unsigned t = 0; t != num_trees; ++t){
+			for(unsigned i = 0; i != depth; ++i){
+				ss << R"(<g fill="red">)";
+			}
+			ss << R"(<use xlink:href="#a"/>)";
+			for(unsigned i = 0; i != depth; ++i){
+				ss << "</g>";
+			}
+		}
+		ss << "</svg>";
+		auto str = ss.str();
+
+		constexpr unsigned num_iterations = 5;
+
+		auto start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			auto dom = svgdom::load(std::string_view(str));
+			tst::check(dom != nullptr, SL);
+			tst::check_eq(dom->children.size(), size_t(num_trees), SL);
+		}
+		auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+		auto num_elements = uint64_t(num_trees) * (depth + 1) * num_iterations;
+
+		utki::log([&](auto&o){
+			o << "depth " << depth << ", " << num_elements << " elements parsed in " << float(ms) / 1000.0f << " sec, ";
+			o << float(num_elements) / (float(ms) / 1000.0f) << " elements/sec" << std::endl;
+		});
+	});
+
+	suite.add("stream_vs_load", [](){
+		constexpr unsigned num_paths = 100000;
+
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+		for(unsigned i = 0; i != num_paths; ++i){
+			ss << R"(<g><path d="M 10,10 L 20,20 C 30,30 40,40 50,50 z" fill="red"/></g>)";
+		}
+		ss << "</svg>";
+		auto str = ss.str();
+
+		auto load_start = utki::get_ticks_ms();
+		size_t num_loaded_elements = 0;
+		{
+			auto dom = svgdom::load(std::string_view(str));
+			tst::check(dom != nullptr, SL);
+			path_segment_counter counter;
+			dom->accept(counter);
+			num_loaded_elements = counter.num_elements;
+		}
+		auto load_ms = utki::get_ticks_ms() - load_start;
+
+		auto stream_start = utki::get_ticks_ms();
+		path_segment_counter counter;
+		svgdom::stream(std::string_view(str), counter);
+		auto stream_ms = utki::get_ticks_ms() - stream_start;
+
+		tst::check_eq(counter.num_elements, num_loaded_elements, SL);
+		tst::check_eq(counter.num_segments, size_t(num_paths) * 4, SL);
+
+		utki::log([&](auto&o){
+			o << counter.num_elements << " elements, " << counter.num_segments << " path segments:" << std::endl;
+			o << "  load + visit: " << float(load_ms) / 1000.0f << " sec." << std::endl;
+			o << "  stream:       " << float(stream_ms) / 1000.0f << " sec." << std::endl;
+		});
+	});
+
+	suite.add("selective_loading", [](){
+		auto buf = fsif::native_file("samples_data/back.svg").load();
+		auto str = std::string_view(reinterpret_cast<const char*>(buf.data()), buf.size());
+
+		// what a thumbnail renderer does not need
+		svgdom::load_options options;
+		options.skip(svgdom::element_kind::filter)
+			.skip(svgdom::element_kind::mask)
+			.skip(svgdom::element_kind::text)
+			.skip(svgdom::element_kind::style)
+			.skip(svgdom::element_kind::image);
+
+		constexpr unsigned num_iterations = 5;
+
+		auto full_start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			auto res = svgdom::try_load(str);
+			tst::check(res, SL);
+		}
+		auto full_ms = utki::get_ticks_ms() - full_start;
+
+		svgdom::load_stats stats;
+
+		auto selective_start = utki::get_ticks_ms();
+		for(unsigned i = 0; i != num_iterations; ++i){
+			auto res = svgdom::try_load(str, options);
+			tst::check(res, SL);
+			stats = res.stats;
+		}
+		auto selective_ms = utki::get_ticks_ms() - selective_start;
+
+		utki::log([&](auto&o){
+			o << "back.svg, " << num_iterations << " loads:" << std::endl;
+			o << "  full:      " << float(full_ms) / 1000.0f << " sec." << std::endl;
+			o << "  selective: " << float(selective_ms) / 1000.0f << " sec., "
+				<< stats.parsed_bytes << " bytes parsed, " << stats.skipped_bytes << " bytes skipped" << std::endl;
+		});
+	});
+
+	suite.add("parallel_decoding_scaling", [](){
+		constexpr unsigned num_paths = 100000;
+
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+		for(unsigned i = 0; i != num_paths; ++i){
+			ss << R"x(<path transform="translate(10, 20) rotate(45) scale(2)" style="fill:#ff0000;stroke:blue;stroke-width:2;opacity:0.5")x"
+				<< R"( d="M 10,10 L 20,20 C 30,30 40,40 50,50 Q 60,60 70,70 A 5,5 0 1 0 80,80 H 90 V 100 z)"
+				<< R"( m 1.5 -2.25 l 3e1 4.5e-1 c 1,2 3,4 5,6 s 7,8 9,10 t 11,12 z"/>)";
+		}
+		ss << "</svg>";
+		auto str = ss.str();
+
+		auto max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+
+		uint32_t single_thread_ms = 0;
+
+		for(unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2){
+			svgdom::load_options options;
+			options.num_threads = num_threads;
+
+			auto start = utki::get_ticks_ms();
+			auto dom = svgdom::load(std::string_view(str), options);
+			auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+			tst::check(dom != nullptr, SL);
+			tst::check_eq(dom->children.size(), size_t(num_paths), SL);
+
+			if(num_threads == 1){
+				single_thread_ms = ms;
+			}
+
+			utki::log([&](auto&o){
+				o << num_paths << " paths, " << num_threads << " threads: " << float(ms) / 1000.0f << " sec., speedup "
+					<< float(single_thread_ms) / float(ms) << std::endl;
+			});
+		}
+	});
+
+	suite.add("pipelined_loading", [](){
+		constexpr unsigned num_paths = 100000;
+
+		std::stringstream ss;
+		ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+		for(unsigned i = 0; i != num_paths; ++i){
+			ss << R"x(<g transform="translate(10, 20)"><path style="fill:#ff0000;stroke:blue" d="M 10,10 L 20,20 C 30,30 40,40 50,50 z"/></g>)x";
+		}
+		ss << "</svg>";
+		auto str = ss.str();
+
+		constexpr size_t chunk_size = size_t(64) * 1024;
+
+		auto plain_start = utki::get_ticks_ms();
+		{
+			slow_source_buffer source(str, chunk_size);
+			std::istream s(&source);
+			auto dom = svgdom::load(s);
+			tst::check(dom != nullptr, SL);
+		}
+		auto plain_ms = utki::get_ticks_ms() - plain_start;
+
+		auto pipelined_start = utki::get_ticks_ms();
+		{
+			slow_source_buffer source(str, chunk_size);
+			svgdom::pipelined_loader loader;
+			std::vector<char> buf(chunk_size);
+			while(auto n = source.read(utki::make_span(buf))){
+				loader.feed(utki::make_span(buf.data(), n));
+			}
+			auto dom = loader.end();
+			tst::check(dom != nullptr, SL);
+			tst::check_eq(dom->children.size(), size_t(num_paths), SL);
+		}
+		auto pipelined_ms = utki::get_ticks_ms() - pipelined_start;
+
+		utki::log([&](auto&o){
+			o << str.size() << " bytes from slow source by " << chunk_size << " bytes chunks:" << std::endl;
+			o << "  plain:     " << float(plain_ms) / 1000.0f << " sec." << std::endl;
+			o << "  pipelined: " << float(pipelined_ms) / 1000.0f << " sec." << std::endl;
+		});
+	});
+
+	suite.add("per_document_overhead_of_icons", [](){
+		constexpr unsigned num_icons = 10000;
+
+		std::vector<std::string> icons;
+		icons.reserve(num_icons);
+		size_t num_bytes = 0;
+		for(unsigned i = 0; i != num_icons; ++i){
+			icons.push_back(make_icon(i));
+			num_bytes += icons.back().size();
+		}
+
+		auto fresh_start = utki::get_ticks_ms();
+		for(const auto& icon : icons){
+			auto dom = svgdom::load(std::string_view(icon));
+			tst::check(dom != nullptr, SL);
+		}
+		auto fresh_ms = utki::get_ticks_ms() - fresh_start;
+
+		svgdom::loader loader;
+
+		auto reused_start = utki::get_ticks_ms();
+		for(const auto& icon : icons){
+			auto dom = loader.load(std::string_view(icon));
+			tst::check(dom != nullptr, SL);
+		}
+		auto reused_ms = utki::get_ticks_ms() - reused_start;
+
+		utki::log([&](auto&o){
+			o << num_icons << " icons, " << num_bytes / num_icons << " bytes on average:" << std::endl;
+			o << "  fresh parser:  " << float(fresh_ms) * 1000.0f / float(num_icons) << " us per icon" << std::endl;
+			o << "  reused parser: " << float(reused_ms) * 1000.0f / float(num_icons) << " us per icon" << std::endl;
+		});
+	});
+
+	suite.add("batch_loading_10k_icons", [](){
+		constexpr unsigned num_icons = 10000;
+
+		std::vector<std::string> icons;
+		icons.reserve(num_icons);
+		size_t num_bytes = 0;
+		for(unsigned i = 0; i != num_icons; ++i){
+			icons.push_back(make_icon(i));
+			num_bytes += icons.back().size();
+		}
+
+		std::vector<utki::span<const char>> buffers;
+		buffers.reserve(icons.size());
+		for(const auto& icon : icons){
+			buffers.push_back(utki::make_span(icon));
+		}
+
+		auto sequential_start = utki::get_ticks_ms();
+		for(const auto& icon : icons){
+			auto dom = svgdom::load(std::string_view(icon));
+			tst::check(dom != nullptr, SL);
+		}
+		auto sequential_ms = std::max(utki::get_ticks_ms() - sequential_start, uint32_t(1));
+
+		utki::log([&](auto&o){
+			o << num_icons << " icons, " << num_bytes << " bytes:" << std::endl;
+			o << "  sequential load(): " << float(sequential_ms) / 1000.0f << " sec." << std::endl;
+		});
+
+		auto max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+
+		for(unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2){
+			svgdom::load_options options;
+			options.num_threads = num_threads;
+
+			auto start = utki::get_ticks_ms();
+			auto results = svgdom::load_batch(utki::make_span(buffers), options);
+			auto ms = std::max(utki::get_ticks_ms() - start, uint32_t(1));
+
+			tst::check_eq(results.size(), size_t(num_icons), SL);
+			tst::check(std::all_of(results.begin(), results.end(), [](const auto& r){return bool(r);}), SL);
+
+			utki::log([&](auto&o){
+				o << "  load_batch(), " << num_threads << " threads: " << float(ms) / 1000.0f << " sec., speedup "
+					<< float(sequential_ms) / float(ms) << std::endl;
+			});
+		}
+	});
 });
 }
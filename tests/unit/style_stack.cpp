@@ -1,6 +1,8 @@
 #include <tst/set.hpp>
 #include <tst/check.hpp>
 
+#include <map>
+
 #include <fsif/span_file.hpp>
 
 #include "../../src/svgdom/visitor.hpp"
@@ -150,5 +152,53 @@ const tst::set set("style_stack", [](auto& suite){
 
 		dom->accept(v);
 	});
+
+	suite.add("add_css_overrides_already_matched_values", [](){
+		auto dom = svgdom::load(fsif::span_file(utki::make_span(R"qwertyuiop(
+<svg xmlns="http://www.w3.org/2000/svg">
+	<style type="text/css">
+		.cls_fill { fill: blue }
+	</style>
+	<style type="text/css">
+		g .cls_fill { fill: yellow }
+	</style>
+	<g>
+		<rect id="rect" class="cls_fill" x="0" y="0" width="100" height="50"/>
+	</g>
+</svg>
+)qwertyuiop")));
+		tst::check(dom, SL);
+		tst::check_eq(dom->children.size(), size_t(3), SL);
+
+		auto first_css = dynamic_cast<const svgdom::style_element*>(dom->children[0].get());
+		auto second_css = dynamic_cast<const svgdom::style_element*>(dom->children[1].get());
+		auto g = dynamic_cast<const svgdom::g_element*>(dom->children[2].get());
+		tst::check(first_css, SL);
+		tst::check(second_css, SL);
+		tst::check(g, SL);
+		auto rect = dynamic_cast<const svgdom::rect_element*>(g->children[0].get());
+		tst::check(rect, SL);
+
+		svgdom::style_stack ss;
+		ss.add_css(first_css->css);
+
+		svgdom::style_stack::push svg_push(ss, *dom);
+		svgdom::style_stack::push g_push(ss, *g);
+		svgdom::style_stack::push rect_push(ss, *rect);
+
+		auto blue = svgdom::parse_paint("blue");
+		auto yellow = svgdom::parse_paint("yellow");
+
+		auto fp = ss.get_style_property(svgdom::style_property::fill);
+		tst::check(fp, SL);
+		tst::check_eq(*std::get_if<uint32_t>(fp), *std::get_if<uint32_t>(&blue), SL);
+
+		// the rule of the second CSS has higher specificity
+		ss.add_css(second_css->css);
+
+		fp = ss.get_style_property(svgdom::style_property::fill);
+		tst::check(fp, SL);
+		tst::check_eq(*std::get_if<uint32_t>(fp), *std::get_if<uint32_t>(&yellow), SL);
+	});
 });
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include <tst/set.hpp>
 #include <tst/check.hpp>
 
+#include <sstream>
+
 #include <utki/time.hpp>
 #include <fsif/native_file.hpp>
 
@@ -8,6 +10,8 @@
 #include "../../src/svgdom/visitor.hpp"
 #include "../../src/svgdom/util/style_stack_cache.hpp"
 
+using namespace std::string_literals;
+
 namespace{
 const tst::set set("style_stack_cache", [](auto& suite){
 	suite.add(
@@ -46,5 +50,85 @@ const tst::set set("style_stack_cache", [](auto& suite){
 				tst::check(visitor.style_stack_cache.size() == 17763, [&](auto&o){o << "visitor.style_stack_cache.size() = " << visitor.style_stack_cache.size();}, SL);
 			}
 		);
+
+	suite.add(
+			"stacks_of_nested_elements",
+			[](){
+				auto dom = svgdom::load(std::string_view(R"qwertyuiop(<svg xmlns="http://www.w3.org/2000/svg" id="root">
+	<g id="g1" fill="red">
+		<rect id="r1"/>
+		<g id="g2">
+			<circle id="c1"/>
+		</g>
+	</g>
+	<rect id="r2"/>
+</svg>)qwertyuiop"));
+				tst::check(dom, SL);
+
+				svgdom::style_stack_cache cache(*dom);
+				tst::check_eq(cache.size(), size_t(6), SL);
+
+				auto stack_ids = [&](const std::string& id){
+					std::vector<std::string> ret;
+					auto n = cache.find(id);
+					tst::check(n, [&](auto&o){o << "element not found for id = " << id;}, SL);
+					for(const auto& s : n->to_style_stack().stack){
+						ret.push_back(std::string(s.get().get_id()));
+					}
+					return ret;
+				};
+
+				tst::check_eq(stack_ids("root"), std::vector<std::string>{"root"}, SL);
+				tst::check_eq(stack_ids("g1"), std::vector<std::string>{"root", "g1"}, SL);
+				tst::check_eq(stack_ids("r1"), std::vector<std::string>{"root", "g1", "r1"}, SL);
+				tst::check_eq(stack_ids("c1"), std::vector<std::string>{"root", "g1", "g2", "c1"}, SL);
+				tst::check_eq(stack_ids("r2"), std::vector<std::string>{"root", "r2"}, SL);
+
+				// the stack is usable for getting style properties
+				auto n = cache.find("c1");
+				tst::check(n, SL);
+				tst::check(n->to_style_stack().get_style_property(svgdom::style_property::fill), SL);
+
+				// stacks share the nodes of common ancestors
+				tst::check_eq(cache.find("r1")->parent, cache.find("g1"), SL);
+				tst::check_eq(cache.find("c1")->parent->parent, cache.find("g1"), SL);
+
+				tst::check(!cache.find(""), SL);
+				tst::check(!cache.find("not_existing"), SL);
+			}
+		);
+
+	suite.add(
+			"deep_document",
+			[](){
+				constexpr unsigned depth = 5000;
+
+				std::stringstream ss;
+				ss << R"(<svg xmlns="http://www.w3.org/2000/svg">)";
+				for(unsigned i = 0; i != depth; ++i){
+					ss << R"(<g id="g)" << i << R"(">)";
+				}
+				for(unsigned i = 0; i != depth; ++i){
+					ss << "</g>";
+				}
+				ss << "</svg>";
+
+				auto dom = svgdom::load(ss.str());
+				tst::check(dom, SL);
+
+				auto start = utki::get_ticks_ms();
+				svgdom::style_stack_cache cache(*dom);
+				utki::log([&](auto&o){o << depth << " nested elements with ids cached in " << float(utki::get_ticks_ms() - start) / 1000.0f << " sec." << std::endl;});
+
+				tst::check_eq(cache.size(), size_t(depth), SL);
+
+				for(unsigned i : {0u, depth / 2, depth - 1}){
+					auto n = cache.find("g"s + std::to_string(i));
+					tst::check(n, SL);
+					// svg element and i + 1 groups
+					tst::check_eq(n->to_style_stack().stack.size(), size_t(i + 2), SL);
+				}
+			}
+		);
 });
 }
@@ -0,0 +1,103 @@
+#include <tst/set.hpp>
+#include <tst/check.hpp>
+
+#include <filesystem>
+
+#include <fsif/native_file.hpp>
+
+#include "../../src/svgdom/dom.hpp"
+#include "../../src/svgdom/visitor.hpp"
+#include "../../src/svgdom/util/casters.hpp"
+#include "../../src/svgdom/util/style_value_pool.hpp"
+
+namespace{
+const tst::set set("style_value_pool", [](auto& suite){
+	suite.add("equal_values_are_interned", [](){
+		svgdom::style_value_pool pool;
+
+		auto a = pool.encode(svgdom::parse_url("url(#gradient)"));
+		auto b = pool.encode(svgdom::parse_url("url(#gradient)"));
+		auto c = pool.encode(svgdom::parse_url("url(#other)"));
+
+		tst::check(a == b, SL);
+		tst::check(a != c, SL);
+		tst::check_eq(pool.get_string(a), std::get<std::string>(svgdom::parse_url("url(#gradient)")), SL);
+
+		auto dashes = std::vector<svgdom::length>{svgdom::length(1), svgdom::length(2, svgdom::length_unit::percent)};
+		auto d1 = pool.encode(dashes);
+		auto d2 = pool.encode(dashes);
+		tst::check(d1 == d2, SL);
+		tst::check_eq(pool.get_dash_array(d1).size(), size_t(2), SL);
+
+		tst::check(pool.encode(svgdom::make_style_value(1, 2, 3)) == pool.encode(svgdom::make_style_value(1, 2, 3)), SL);
+		tst::check(pool.encode(svgdom::make_style_value(1, 2, 3)) != pool.encode(svgdom::make_style_value(1, 2, 4)), SL);
+
+		svgdom::enable_background_property eb{svgdom::enable_background::new_background, {{1, 2}, {3, 4}}};
+		auto e1 = pool.encode(eb);
+		auto e2 = pool.encode(eb);
+		tst::check(e1 == e2, SL);
+		eb.rect.d.y() = 5;
+		tst::check(pool.encode(eb) != e1, SL);
+	});
+
+	suite.add("numbers_are_compared_as_reals", [](){
+		svgdom::style_value_pool pool;
+
+		tst::check(pool.encode(svgdom::real(0)) == pool.encode(svgdom::real(-0.0)), SL);
+		tst::check(pool.encode(svgdom::real(1)) != pool.encode(svgdom::real(2)), SL);
+		tst::check(pool.encode(svgdom::length(0)) == pool.encode(svgdom::length(-0.0)), SL);
+		tst::check(pool.encode(svgdom::length(1)) != pool.encode(svgdom::length(1, svgdom::length_unit::percent)), SL);
+
+		// same bits, different alternatives
+		tst::check(pool.encode(svgdom::real(1)) != pool.encode(svgdom::length(1, svgdom::length_unit::unknown)), SL);
+	});
+
+	suite.add("samples_round_trip", [](){
+		class collector : public svgdom::const_visitor{
+		public:
+			std::vector<const svgdom::style_map*> maps;
+
+			void default_visit(const svgdom::element& e)override{
+				if(auto s = svgdom::cast_to_styleable(&e)){
+					this->maps.push_back(&s->styles);
+					this->maps.push_back(&s->presentation_attributes);
+				}
+			}
+		};
+
+		size_t num_values = 0;
+
+		for(const auto& entry : std::filesystem::directory_iterator("samples_data")){
+			if(entry.path().extension() != ".svg"){
+				continue;
+			}
+
+			auto dom = svgdom::load(fsif::native_file(entry.path().string()));
+			tst::check(dom, SL);
+
+			collector c;
+			dom->accept(c);
+
+			svgdom::style_value_pool pool;
+
+			for(const auto& m : c.maps){
+				for(const auto& [p, v] : *m){
+					auto compact = pool.encode(v);
+					tst::check_eq(compact.index(), v.index(), SL);
+
+					auto decoded = pool.decode(compact);
+					tst::check_eq(
+							svgdom::styleable::style_value_to_string(p, decoded),
+							svgdom::styleable::style_value_to_string(p, v),
+							[&](auto&o){o << "file = " << entry.path();},
+							SL
+						);
+					++num_values;
+				}
+			}
+		}
+
+		tst::check_ne(num_values, size_t(0), SL);
+	});
+});
+}